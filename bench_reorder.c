@@ -0,0 +1,162 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+// Benchmark of the locality orders: time and estimated cache miss rate of a full traversal and
+// of distribution propagation, on the original labels and after each relabelling.
+// Usage: bench_reorder [graph file]   (without a file, a banded chain with shuffled labels is used)
+
+#include <stdint.h>
+#include <time.h>
+#include "functions.h"
+#include "permutation.h"
+#include "distribution.h"
+
+#define CACHE_LINES 512     // direct-mapped model of a 32 KiB cache with 64-byte lines
+#define NB_STEPS 20         // propagation steps per measure
+
+typedef struct {
+    uintptr_t tags[CACHE_LINES];
+    long long accesses;
+    long long misses;
+} t_cache_model;
+
+static void cache_access(t_cache_model *cache, const void *address) {
+    uintptr_t line = (uintptr_t)address / 64;
+    cache->accesses++;
+    if (cache->tags[line % CACHE_LINES] != line) {
+        cache->tags[line % CACHE_LINES] = line;
+        cache->misses++;
+    }
+}
+
+// Banded chain: each state moves to one of its 8 closest states, then the labels are shuffled
+static a_list generate_shuffled_band(int n) {
+    int *label = malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) label[i] = i;
+    srand(12345);
+    for (int i = n - 1; i > 0; i--) {
+        int j = (int)(((long long)rand() * RAND_MAX + rand()) % (i + 1));
+        int swap = label[i];
+        label[i] = label[j];
+        label[j] = swap;
+    }
+    a_list *graph = create_a_list(n);
+    for (int i = 0; i < n; i++) {
+        for (int d = -4; d <= 4; d++) {
+            if (d == 0) continue;
+            int j = (i + d + n) % n;
+            insert_cell(&graph->array[label[i]], label[j] + 1, 0.125f);
+        }
+    }
+    free(label);
+    a_list result = *graph;
+    free(graph);
+    return result;
+}
+
+// Breadth-first traversal touching every edge, with the addresses it reads fed to the cache model
+static double measure_traversal(const a_list *graph, t_cache_model *cache) {
+    int n = graph->size;
+    int *visited = calloc(n, sizeof(int));
+    int *queue = malloc(n * sizeof(int));
+    clock_t begin = clock();
+    int head = 0;
+    int tail = 0;
+    for (int root = 0; root < n; root++) {
+        if (visited[root]) continue;
+        visited[root] = 1;
+        queue[tail++] = root;
+        while (head < tail) {
+            int v = queue[head++];
+            for (cell *c = graph->array[v].head; c != NULL; c = c->next) {
+                int w = c->arr - 1;
+                if (!visited[w]) {
+                    visited[w] = 1;
+                    queue[tail++] = w;
+                }
+            }
+        }
+    }
+    double seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+    // second pass only to count the modelled misses, so it does not disturb the timing
+    memset(visited, 0, n * sizeof(int));
+    head = tail = 0;
+    for (int root = 0; root < n; root++) {
+        if (visited[root]) continue;
+        visited[root] = 1;
+        queue[tail++] = root;
+        while (head < tail) {
+            int v = queue[head++];
+            cache_access(cache, &graph->array[v]);
+            for (cell *c = graph->array[v].head; c != NULL; c = c->next) {
+                cache_access(cache, c);
+                cache_access(cache, &visited[c->arr - 1]);
+                if (!visited[c->arr - 1]) {
+                    visited[c->arr - 1] = 1;
+                    queue[tail++] = c->arr - 1;
+                }
+            }
+        }
+    }
+    free(visited);
+    free(queue);
+    return seconds;
+}
+
+// NB_STEPS steps of step_distribution, then one modelled step for the cache
+static double measure_propagation(a_list *graph, t_cache_model *cache) {
+    int n = graph->size;
+    float *current = malloc(n * sizeof(float));
+    float *next = malloc(n * sizeof(float));
+    for (int v = 0; v < n; v++) current[v] = 1.0f / n;
+    clock_t begin = clock();
+    for (int t = 0; t < NB_STEPS; t++) {
+        step_distribution(graph, current, next);
+        float *swap = current;
+        current = next;
+        next = swap;
+    }
+    double seconds = (double)(clock() - begin) / CLOCKS_PER_SEC;
+    for (int v = 0; v < n; v++) {
+        cache_access(cache, &current[v]);
+        cache_access(cache, &graph->array[v]);
+        for (cell *c = graph->array[v].head; c != NULL; c = c->next) {
+            cache_access(cache, c);
+            cache_access(cache, &next[c->arr - 1]);
+        }
+    }
+    free(current);
+    free(next);
+    return seconds;
+}
+
+static void run(const char *name, a_list *graph) {
+    t_cache_model traversal_cache = {{0}, 0, 0};
+    t_cache_model propagation_cache = {{0}, 0, 0};
+    double traversal = measure_traversal(graph, &traversal_cache);
+    double propagation = measure_propagation(graph, &propagation_cache);
+    printf("%-10s traversal %8.3f s (miss rate %5.1f%%)   propagation x%d %8.3f s (miss rate %5.1f%%)\n",
+           name, traversal, 100.0 * traversal_cache.misses / traversal_cache.accesses,
+           NB_STEPS, propagation, 100.0 * propagation_cache.misses / propagation_cache.accesses);
+}
+
+int main(int argc, char **argv) {
+    a_list graph = (argc > 1) ? readGraph(argv[1]) : generate_shuffled_band(1000000);
+    printf("%d vertices\n", graph.size);
+    run("original", &graph);
+    const char *names[] = {"RCM", "BFS", "degree"};
+    t_order_strategy strategies[] = {ORDER_RCM, ORDER_BFS, ORDER_DEGREE};
+    for (int s = 0; s < 3; s++) {
+        clock_t begin = clock();
+        t_permutation *perm = locality_permutation(&graph, strategies[s]);
+        if (perm == NULL) return EXIT_FAILURE;
+        a_list permuted = permute_graph(&graph, perm);
+        printf("(%s order built in %.3f s)\n", names[s], (double)(clock() - begin) / CLOCKS_PER_SEC);
+        run(names[s], &permuted);
+        for (int v = 0; v < permuted.size; v++) free_list(&permuted.array[v]);
+        free(permuted.array);
+        free_permutation(perm);
+    }
+    return 0;
+}
@@ -0,0 +1,316 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "cache.h"
+#include "limit.h"
+
+// On-disk cache of the structural analysis of graph files.
+// An entry is named after the 64-bit content hash of the file it was computed from, so a file
+// that changes simply gets a new key: stale entries are never read again and nothing has to be
+// invalidated by hand. Entries are written to a temporary file first and renamed, so a reader
+// never sees a half-written entry.
+// Layout of an entry (native byte order, checked with the magic number):
+//   magic, hash, size, nb_classes, nb_links, has_stationary,
+//   for each class: its size, its transient flag and its vertices,
+//   the link starts, the link ends, then the stationary vector if present.
+
+#define CACHE_MAGIC 0x314B434DU     // "MKC1"
+#define HASH_CHUNK 65536            // bytes read at a time (a multiple of 8)
+
+
+// SplitMix64 finaliser, mixes one 64-bit word into the hash
+static uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Function that computes the content hash of a file, 8 bytes at a time (returns 0 on failure)
+int hash_file(const char *filename, uint64_t *hash) {
+    FILE *file = fopen(filename, "rb");
+    if (file == NULL) {
+        perror("Could not open file for hashing");
+        return 0;
+    }
+    unsigned char *buffer = malloc(HASH_CHUNK);
+    if (buffer == NULL) {
+        fprintf(stderr, "Memory allocation error for file hashing (sorry ;()\n");
+        fclose(file);
+        return 0;
+    }
+    uint64_t h = 0x6A09E667F3BCC908ULL;
+    uint64_t length = 0;
+    size_t nb_read;
+    while ((nb_read = fread(buffer, 1, HASH_CHUNK, file)) > 0) {
+        // the last word of the file is padded with zeros, which the length does not count
+        length += nb_read;
+        while (nb_read % 8 != 0) buffer[nb_read++] = 0;
+        for (size_t k = 0; k < nb_read; k += 8) {
+            uint64_t word;
+            memcpy(&word, &buffer[k], 8);
+            h = mix64(h ^ word);
+        }
+    }
+    int ok = !ferror(file);
+    free(buffer);
+    fclose(file);
+    if (!ok) {
+        perror("Could not read file for hashing");
+        return 0;
+    }
+    *hash = mix64(h ^ length);
+    return 1;
+}
+
+// Path of the entry of a hash in a cache directory (to be freed)
+static char* entry_path(const char *cache_dir, uint64_t hash, const char *suffix) {
+    size_t length = strlen(cache_dir) + strlen(suffix) + 24;
+    char *path = malloc(length);
+    if (path != NULL) {
+        snprintf(path, length, "%s/%016llx%s", cache_dir, (unsigned long long)hash, suffix);
+    }
+    return path;
+}
+
+static int read_ints(FILE *file, int *values, int count) {
+    return count == 0 || fread(values, sizeof(int), count, file) == (size_t)count;
+}
+
+// Function that reads the cached analysis of a hash (NULL when there is none or it is unreadable)
+t_cached_analysis* load_cached_analysis(const char *cache_dir, uint64_t hash) {
+    char *path = entry_path(cache_dir, hash, ".mkc");
+    if (path == NULL) return NULL;
+    FILE *file = fopen(path, "rb");
+    free(path);
+    if (file == NULL) return NULL;  // not cached yet
+    t_cached_analysis *cached = calloc(1, sizeof(t_cached_analysis));
+    uint32_t magic = 0;
+    uint64_t stored_hash = 0;
+    int header[4];  // size, nb_classes, nb_links, has_stationary
+    int ok = cached != NULL && fread(&magic, sizeof(magic), 1, file) == 1 && magic == CACHE_MAGIC &&
+             fread(&stored_hash, sizeof(stored_hash), 1, file) == 1 && stored_hash == hash &&
+             read_ints(file, header, 4) && header[0] >= 0 && header[1] >= 0 && header[1] <= header[0] &&
+             header[2] >= 0;
+    if (ok) {
+        cached->hash = hash;
+        cached->from_cache = 1;
+        cached->size = header[0];
+        cached->nb_links = header[2];
+        t_partition *partition = &cached->classification.partition;
+        partition->classes = malloc((header[1] > 0 ? header[1] : 1) * sizeof(t_class));
+        partition->capacity = header[1];
+        cached->classification.flags = malloc((header[1] > 0 ? header[1] : 1) * sizeof(t_class_flags));
+        cached->link_from = malloc((header[2] > 0 ? header[2] : 1) * sizeof(int));
+        cached->link_to = malloc((header[2] > 0 ? header[2] : 1) * sizeof(int));
+        char *seen = calloc(header[0] > 0 ? header[0] : 1, 1);  // each vertex in exactly one class
+        int nb_seen = 0;
+        ok = partition->classes != NULL && cached->classification.flags != NULL &&
+             cached->link_from != NULL && cached->link_to != NULL && seen != NULL;
+        for (int c = 0; c < header[1] && ok; c++) {
+            int class_header[2];  // size, transient
+            ok = read_ints(file, class_header, 2) && class_header[0] > 0 && class_header[0] <= header[0];
+            if (!ok) break;
+            int size = class_header[0];
+            t_class cls;
+            cls.name = malloc(13 * sizeof(char));
+            cls.vertices = malloc(size * sizeof(t_tarjan_vertex));
+            cls.size = 0;
+            cls.capacity = size;
+            int *ids = malloc(size * sizeof(int));
+            ok = cls.name != NULL && cls.vertices != NULL && ids != NULL && read_ints(file, ids, size);
+            for (int k = 0; k < size && ok; k++) {
+                ok = ids[k] >= 0 && ids[k] < header[0] && !seen[ids[k]];
+                if (ok) seen[ids[k]] = 1;
+            }
+            nb_seen += size;
+            if (ok) {
+                snprintf(cls.name, 13, "C%d", c + 1);
+                for (int k = 0; k < size; k++) {
+                    // Tarjan numbers are not stored, only the vertices
+                    t_tarjan_vertex member = {ids[k], -1, -1, 0};
+                    cls.vertices[cls.size++] = member;
+                }
+                t_class_flags *flags = &cached->classification.flags[c];
+                flags->size = size;
+                flags->transient = class_header[1] != 0;
+                flags->persistent = !flags->transient;
+                flags->absorbing = flags->persistent && size == 1;
+                cached->classification.nb_transient += flags->transient;
+                cached->classification.nb_persistent += flags->persistent;
+                cached->classification.nb_absorbing += flags->absorbing;
+                partition->classes[partition->size++] = cls;
+            } else {
+                free(cls.name);
+                free(cls.vertices);
+            }
+            free(ids);
+        }
+        free(seen);
+        ok = ok && nb_seen == header[0];  // no vertex left out
+        cached->classification.irreducible = (partition->size == 1);
+        ok = ok && read_ints(file, cached->link_from, cached->nb_links) &&
+             read_ints(file, cached->link_to, cached->nb_links);
+        for (int k = 0; k < cached->nb_links && ok; k++) {
+            ok = cached->link_from[k] >= 0 && cached->link_from[k] < header[1] && cached->link_to[k] >= 0 &&
+                 cached->link_to[k] < header[1];
+        }
+        if (ok && header[3]) {
+            cached->stationary = malloc((cached->size > 0 ? cached->size : 1) * sizeof(float));
+            ok = cached->stationary != NULL &&
+                 fread(cached->stationary, sizeof(float), cached->size, file) == (size_t)cached->size;
+        }
+    }
+    fclose(file);
+    if (!ok) {
+        fprintf(stderr, "Ignoring unreadable cache entry %016llx\n", (unsigned long long)hash);
+        free_cached_analysis(cached);
+        return NULL;
+    }
+    return cached;
+}
+
+// Function that writes an analysis to the cache (returns 0 on failure)
+int store_cached_analysis(const char *cache_dir, const t_cached_analysis *cached) {
+    char *path = entry_path(cache_dir, cached->hash, ".mkc");
+    char *temporary = entry_path(cache_dir, cached->hash, ".tmp");
+    FILE *file = (path != NULL && temporary != NULL) ? fopen(temporary, "wb") : NULL;
+    if (file == NULL) {
+        fprintf(stderr, "Could not write cache entry in %s\n", cache_dir);
+        free(path);
+        free(temporary);
+        return 0;
+    }
+    const t_partition *partition = &cached->classification.partition;
+    uint32_t magic = CACHE_MAGIC;
+    int header[4] = {cached->size, partition->size, cached->nb_links, cached->stationary != NULL};
+    int ok = fwrite(&magic, sizeof(magic), 1, file) == 1 &&
+             fwrite(&cached->hash, sizeof(cached->hash), 1, file) == 1 &&
+             fwrite(header, sizeof(int), 4, file) == 4;
+    for (int c = 0; c < partition->size && ok; c++) {
+        int class_header[2] = {partition->classes[c].size, cached->classification.flags[c].transient};
+        ok = fwrite(class_header, sizeof(int), 2, file) == 2;
+        for (int k = 0; k < partition->classes[c].size && ok; k++) {
+            ok = fwrite(&partition->classes[c].vertices[k].identifier, sizeof(int), 1, file) == 1;
+        }
+    }
+    ok = ok && fwrite(cached->link_from, sizeof(int), cached->nb_links, file) == (size_t)cached->nb_links &&
+         fwrite(cached->link_to, sizeof(int), cached->nb_links, file) == (size_t)cached->nb_links;
+    if (ok && cached->stationary != NULL) {
+        ok = fwrite(cached->stationary, sizeof(float), cached->size, file) == (size_t)cached->size;
+    }
+    ok = (fclose(file) == 0) && ok;
+    if (ok) {
+        remove(path);  // rename does not replace an existing file everywhere
+        ok = rename(temporary, path) == 0;
+    }
+    if (!ok) {
+        fprintf(stderr, "Could not write cache entry in %s\n", cache_dir);
+        remove(temporary);
+    }
+    free(path);
+    free(temporary);
+    return ok;
+}
+
+// Analyse a graph from scratch: classification, class links and optionally stationary vectors
+static t_cached_analysis* analyse_graph(a_list *graph, uint64_t hash, int with_stationary) {
+    t_cached_analysis *cached = calloc(1, sizeof(t_cached_analysis));
+    if (cached == NULL) {
+        fprintf(stderr, "Memory allocation error for analysis (sorry ;()\n");
+        return NULL;
+    }
+    cached->hash = hash;
+    cached->size = graph->size;
+    cached->classification = classify_graph(graph);
+    t_partition *partition = &cached->classification.partition;
+    int *vertex_to_class = create_vertex_to_class(partition, graph->size);
+    int *mark = malloc((partition->size > 0 ? partition->size : 1) * sizeof(int));
+    int capacity = 16;
+    cached->link_from = malloc(capacity * sizeof(int));
+    cached->link_to = malloc(capacity * sizeof(int));
+    int ok = cached->classification.flags != NULL && vertex_to_class != NULL && mark != NULL &&
+             cached->link_from != NULL && cached->link_to != NULL;
+    // class links, each one once
+    for (int c = 0; c < partition->size && ok; c++) mark[c] = -1;
+    for (int c = 0; c < partition->size && ok; c++) {
+        for (int k = 0; k < partition->classes[c].size && ok; k++) {
+            for (cell *e = graph->array[partition->classes[c].vertices[k].identifier].head; e != NULL; e = e->next) {
+                int d = vertex_to_class[e->arr - 1];
+                if (d == c || mark[d] == c) continue;
+                mark[d] = c;
+                if (cached->nb_links >= capacity) {
+                    capacity *= 2;
+                    int *from = realloc(cached->link_from, capacity * sizeof(int));
+                    if (from != NULL) cached->link_from = from;
+                    int *to = realloc(cached->link_to, capacity * sizeof(int));
+                    if (to != NULL) cached->link_to = to;
+                    if (from == NULL || to == NULL) {
+                        ok = 0;
+                        break;
+                    }
+                }
+                cached->link_from[cached->nb_links] = c;
+                cached->link_to[cached->nb_links++] = d;
+            }
+        }
+    }
+    if (ok && with_stationary) {
+        cached->stationary = calloc(graph->size > 0 ? graph->size : 1, sizeof(float));
+        ok = cached->stationary != NULL;
+        for (int c = 0; c < partition->size && ok; c++) {
+            if (!cached->classification.flags[c].persistent) continue;
+            matrix *block = class_block(graph, &partition->classes[c]);
+            float *pi = (block != NULL) ? stationary_from_submatrix(block) : NULL;
+            if (pi == NULL) {
+                // no stationary distribution rather than zeros that would stay in the cache
+                fprintf(stderr, "Could not solve the stationary distribution of class %s\n",
+                        partition->classes[c].name);
+                free_matrix(block);
+                free(cached->stationary);
+                cached->stationary = NULL;
+                break;
+            }
+            for (int k = 0; k < partition->classes[c].size; k++) {
+                cached->stationary[partition->classes[c].vertices[k].identifier] = pi[k];
+            }
+            free(pi);
+            free_matrix(block);
+        }
+    }
+    free(vertex_to_class);
+    free(mark);
+    if (!ok) {
+        fprintf(stderr, "Memory allocation error for analysis (sorry ;()\n");
+        free_cached_analysis(cached);
+        return NULL;
+    }
+    return cached;
+}
+
+// Function that gives the analysis of a graph file, from the cache when the same content was
+// already analysed, otherwise by reading and analysing the file and storing the result
+t_cached_analysis* analyse_with_cache(const char *filename, const char *cache_dir, int with_stationary) {
+    uint64_t hash;
+    if (!hash_file(filename, &hash)) return NULL;
+    t_cached_analysis *cached = load_cached_analysis(cache_dir, hash);
+    if (cached != NULL && (cached->stationary != NULL || !with_stationary)) return cached;
+    free_cached_analysis(cached);
+    a_list graph = readGraph(filename);
+    cached = analyse_graph(&graph, hash, with_stationary);
+    for (int v = 0; v < graph.size; v++) free_list(&graph.array[v]);
+    free(graph.array);
+    if (cached != NULL) store_cached_analysis(cache_dir, cached);
+    return cached;
+}
+
+// Function that frees a cached analysis
+void free_cached_analysis(t_cached_analysis *cached) {
+    if (cached == NULL) return;
+    free_classification(&cached->classification);
+    free(cached->link_from);
+    free(cached->link_to);
+    free(cached->stationary);
+    free(cached);
+}
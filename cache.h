@@ -0,0 +1,33 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef CACHE_H
+#define CACHE_H
+#include <stdint.h>
+#include "functions.h"
+
+// Analysis of one graph file, as stored in the cache
+typedef struct {
+    uint64_t hash;                      // Content hash of the graph file
+    int size;                           // Number of vertices
+    t_classification classification;   // Partition and flags of every class
+    int nb_links;                       // Number of class links
+    int *link_from;                     // Class index (0-based) at the start of each link
+    int *link_to;                       // Class index (0-based) at the end of each link
+    float *stationary;                  // Stationary probability of each vertex inside its persistent
+                                        // class (0 for transient vertices), NULL if not stored or not solved
+    int from_cache;                     // 1 if the analysis was read from the cache
+} t_cached_analysis;
+
+int hash_file(const char *, uint64_t *);
+
+t_cached_analysis* analyse_with_cache(const char *, const char *, int);
+
+t_cached_analysis* load_cached_analysis(const char *, uint64_t);
+
+int store_cached_analysis(const char *, const t_cached_analysis *);
+
+void free_cached_analysis(t_cached_analysis *);
+
+#endif //CACHE_H
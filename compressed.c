@@ -0,0 +1,354 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "compressed.h"
+
+// Compressed read-only graph: the targets of each vertex are sorted and stored as varint
+// (LEB128) differences, so most edges take one byte for their target, and the probabilities
+// can be stored on 16 bits. Compared with the 16 bytes of a cell, an edge takes 3 to 5 bytes.
+// Traversal goes through t_edge_iterator, which decodes the stream on the fly.
+
+
+static void compressed_alloc_error(void) {
+    fprintf(stderr, "Memory allocation error in compressed graph (Never sure how that happens honestly. Unfreed memory? Problem with the engine? Take your guess :p)\n");
+    exit(EXIT_FAILURE);
+}
+
+// Growing byte buffer used while encoding
+typedef struct {
+    unsigned char *bytes;
+    uint64_t size;
+    uint64_t capacity;
+} t_byte_buffer;
+
+static void buffer_put(t_byte_buffer *buffer, unsigned char byte) {
+    if (buffer->size >= buffer->capacity) {
+        buffer->capacity = (buffer->capacity == 0) ? 1024 : buffer->capacity * 2;
+        buffer->bytes = realloc(buffer->bytes, buffer->capacity);
+        if (buffer->bytes == NULL) compressed_alloc_error();
+    }
+    buffer->bytes[buffer->size++] = byte;
+}
+
+// Unsigned LEB128: 7 bits per byte, high bit set when more bytes follow
+static void put_varint(t_byte_buffer *buffer, uint32_t value) {
+    while (value >= 0x80) {
+        buffer_put(buffer, (unsigned char)(value | 0x80));
+        value >>= 7;
+    }
+    buffer_put(buffer, (unsigned char)value);
+}
+
+static uint32_t get_varint(const unsigned char **cursor) {
+    uint32_t value = 0;
+    int shift = 0;
+    unsigned char byte;
+    do {
+        byte = *(*cursor)++;
+        value |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+    return value;
+}
+
+// IEEE 754 binary32 -> binary16, rounding to nearest even
+static uint16_t float_to_half(float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int32_t exponent = (int32_t)((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+    if (((bits >> 23) & 0xFF) == 0xFF) return (uint16_t)(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+    if (exponent >= 31) return (uint16_t)(sign | 0x7C00);  // too big: infinity
+    if (exponent <= 0) {
+        if (exponent < -10) return (uint16_t)sign;  // too small: zero
+        // subnormal half: the implicit bit becomes explicit
+        mantissa |= 0x800000;
+        int shift = 14 - exponent;
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1))) half++;
+        return (uint16_t)(sign | half);
+    }
+    uint32_t half = sign | ((uint32_t)exponent << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) half++;  // a carry correctly bumps the exponent
+    return (uint16_t)half;
+}
+
+// IEEE 754 binary16 -> binary32 (exact)
+static float half_to_float(uint16_t half) {
+    uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FF;
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // subnormal half: normalise it
+            exponent = 127 - 15 + 1;
+            while (!(mantissa & 0x400)) {
+                mantissa <<= 1;
+                exponent--;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+        }
+    } else if (exponent == 31) {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+static void put_proba(t_byte_buffer *buffer, float proba, t_proba_encoding encoding) {
+    unsigned char bytes[4];
+    int nb_bytes = 2;
+    if (encoding == PROBA_FLOAT) {
+        memcpy(bytes, &proba, 4);
+        nb_bytes = 4;
+    } else {
+        uint16_t code = (encoding == PROBA_FIXED16) ? (uint16_t)(proba * 65535.0f + 0.5f) : float_to_half(proba);
+        bytes[0] = (unsigned char)(code & 0xFF);
+        bytes[1] = (unsigned char)(code >> 8);
+    }
+    for (int i = 0; i < nb_bytes; i++) buffer_put(buffer, bytes[i]);
+}
+
+static float get_proba_code(const unsigned char **cursor, t_proba_encoding encoding) {
+    const unsigned char *bytes = *cursor;
+    float proba;
+    if (encoding == PROBA_FLOAT) {
+        memcpy(&proba, bytes, 4);
+        *cursor += 4;
+        return proba;
+    }
+    uint16_t code = (uint16_t)(bytes[0] | (bytes[1] << 8));
+    *cursor += 2;
+    return (encoding == PROBA_FIXED16) ? code * (1.0f / 65535.0f) : half_to_float(code);
+}
+
+// Function that builds the compressed copy of a graph
+// Returns NULL if PROBA_FIXED16 is asked for probabilities outside [0, 1]
+t_compressed_graph* compress_graph(const a_list *graph, t_proba_encoding encoding) {
+    if (graph == NULL || graph->array == NULL) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return NULL;
+    }
+    t_compressed_graph *compressed = malloc(sizeof(t_compressed_graph));
+    if (compressed == NULL) compressed_alloc_error();
+    compressed->size = graph->size;
+    compressed->nb_edges = 0;
+    compressed->encoding = encoding;
+    compressed->offsets = malloc((graph->size + 1) * sizeof(uint64_t));
+    if (compressed->offsets == NULL) compressed_alloc_error();
+    t_byte_buffer buffer = {NULL, 0, 0};
+    cell *sorted = NULL;
+    int sorted_capacity = 0;
+    for (int v = 0; v < graph->size; v++) {
+        compressed->offsets[v] = buffer.size;
+        int degree = 0;
+        for (cell *c = graph->array[v].head; c != NULL; c = c->next) degree++;
+        if (degree > sorted_capacity) {
+            sorted_capacity = degree;
+            sorted = realloc(sorted, sorted_capacity * sizeof(cell));
+            if (sorted == NULL) compressed_alloc_error();
+        }
+        int k = 0;
+        for (cell *c = graph->array[v].head; c != NULL; c = c->next) {
+            if (encoding == PROBA_FIXED16 && !(c->proba >= 0 && c->proba <= 1)) {
+                fprintf(stderr, "Error: Probability %f of edge %d -> %d does not fit 16-bit fixed point\n",
+                        c->proba, v + 1, c->arr);
+                free(sorted);
+                free(buffer.bytes);
+                free(compressed->offsets);
+                free(compressed);
+                return NULL;
+            }
+            sorted[k++] = *c;
+        }
+        qsort(sorted, degree, sizeof(cell), compare_cells);  // already sorted after readGraph
+        put_varint(&buffer, (uint32_t)degree);
+        int previous = 0;
+        for (k = 0; k < degree; k++) {
+            put_varint(&buffer, (uint32_t)(sorted[k].arr - 1 - previous));
+            previous = sorted[k].arr - 1;
+            put_proba(&buffer, sorted[k].proba, encoding);
+        }
+        compressed->nb_edges += degree;
+    }
+    compressed->offsets[graph->size] = buffer.size;
+    free(sorted);
+    // give back the unused end of the buffer
+    compressed->data = (buffer.size > 0) ? realloc(buffer.bytes, buffer.size) : buffer.bytes;
+    if (compressed->data == NULL) compressed->data = buffer.bytes;
+    return compressed;
+}
+
+// Function that frees a compressed graph
+void free_compressed_graph(t_compressed_graph *compressed) {
+    if (compressed == NULL) return;
+    free(compressed->offsets);
+    free(compressed->data);
+    free(compressed);
+}
+
+// Function that places an iterator before the first edge of a vertex (0-based)
+void compressed_edges(const t_compressed_graph *compressed, int vertex, t_edge_iterator *it) {
+    it->cursor = compressed->data + compressed->offsets[vertex];
+    it->remaining = (int)get_varint(&it->cursor);
+    it->encoding = compressed->encoding;
+    it->arr = 1;  // previous target + 1, the first difference is from vertex 0
+    it->proba = 0;
+}
+
+// Function that decodes the next edge. Returns 0 when there is none left
+int next_edge(t_edge_iterator *it) {
+    if (it->remaining == 0) return 0;
+    it->remaining--;
+    it->arr += (int)get_varint(&it->cursor);
+    it->proba = get_proba_code(&it->cursor, it->encoding);
+    return 1;
+}
+
+// Function that gives the number of bytes used by a compressed graph
+size_t compressed_graph_memory(const t_compressed_graph *compressed) {
+    return sizeof(t_compressed_graph) + (compressed->size + 1) * sizeof(uint64_t) +
+           compressed->offsets[compressed->size];
+}
+
+// Function that gives the number of bytes used by an adjacency list (allocator overhead excluded)
+size_t a_list_memory(const a_list *graph) {
+    size_t bytes = sizeof(a_list) + graph->size * sizeof(list);
+    for (int v = 0; v < graph->size; v++) {
+        bytes += ((graph->array[v].capacity > 0) ? graph->array[v].capacity : graph->array[v].size) * sizeof(cell);
+    }
+    return bytes;
+}
+
+// Function that builds back an adjacency list (with the rounded probabilities)
+a_list decompress_graph(const t_compressed_graph *compressed) {
+    a_list *graph = create_a_list(compressed->size);
+    t_edge_iterator it;
+    for (int v = 0; v < compressed->size; v++) {
+        compressed_edges(compressed, v, &it);
+        list *l = &graph->array[v];
+        if (it.remaining == 0) continue;
+        l->capacity = it.remaining;
+        l->head = malloc(l->capacity * sizeof(cell));
+        if (l->head == NULL) compressed_alloc_error();
+        while (next_edge(&it)) {
+            l->head[l->size].arr = it.arr;
+            l->head[l->size].proba = it.proba;
+            l->size++;
+        }
+        relink_block(l, 0);
+    }
+    a_list result = *graph;
+    free(graph);
+    return result;
+}
+
+// Function that computes the strongly connected components of a compressed graph
+// Same algorithm and same class order as compute_partition, with an explicit stack of iterators
+t_partition compute_partition_compressed(const t_compressed_graph *compressed) {
+    int n = compressed->size;
+    t_partition partition;
+    partition.classes = malloc(n * sizeof(t_class));
+    partition.size = 0;
+    partition.capacity = n;
+    t_tarjan_vertex *vertices = malloc(n * sizeof(t_tarjan_vertex));
+    int *stack = malloc(n * sizeof(int));
+    int *call_stack = malloc(n * sizeof(int));
+    t_edge_iterator *iterators = malloc(n * sizeof(t_edge_iterator));
+    if ((partition.classes == NULL || vertices == NULL || stack == NULL || call_stack == NULL ||
+         iterators == NULL) && n > 0) {
+        compressed_alloc_error();
+    }
+    for (int v = 0; v < n; v++) {
+        vertices[v].identifier = v;
+        vertices[v].number = -1;
+        vertices[v].acc_number = -1;
+        vertices[v].indic = 0;
+    }
+    int num = 0;
+    int top = -1;
+    for (int root = 0; root < n; root++) {
+        if (vertices[root].number != -1) continue;
+        int depth = 0;
+        call_stack[depth] = root;
+        compressed_edges(compressed, root, &iterators[depth]);
+        vertices[root].number = vertices[root].acc_number = num++;
+        vertices[root].indic = 1;
+        stack[++top] = root;
+        depth++;
+        while (depth > 0) {
+            int v = call_stack[depth - 1];
+            t_tarjan_vertex *current = &vertices[v];
+            if (next_edge(&iterators[depth - 1])) {
+                int w = iterators[depth - 1].arr - 1;
+                t_tarjan_vertex *next = &vertices[w];
+                if (next->number == -1) {
+                    // next not visited: descend
+                    next->number = next->acc_number = num++;
+                    next->indic = 1;
+                    stack[++top] = w;
+                    call_stack[depth] = w;
+                    compressed_edges(compressed, w, &iterators[depth]);
+                    depth++;
+                } else if (next->indic == 1 && current->acc_number > next->number) {
+                    current->acc_number = next->number;
+                }
+                continue;
+            }
+            depth--;
+            if (current->acc_number == current->number) {
+                // current is a root: pop its class
+                t_class new_class;
+                new_class.name = malloc(13 * sizeof(char));
+                if (new_class.name == NULL) compressed_alloc_error();
+                snprintf(new_class.name, 13, "C%d", partition.size + 1);
+                int size = 0;
+                while (stack[top - size] != v) size++;
+                size++;
+                new_class.vertices = malloc(size * sizeof(t_tarjan_vertex));
+                if (new_class.vertices == NULL) compressed_alloc_error();
+                new_class.size = 0;
+                new_class.capacity = size;
+                int w_vertex = -1;
+                while (w_vertex != v) {
+                    w_vertex = stack[top--];
+                    vertices[w_vertex].indic = 0;
+                    new_class.vertices[new_class.size++] = vertices[w_vertex];
+                }
+                partition.classes[partition.size++] = new_class;
+            }
+            if (depth > 0) {
+                t_tarjan_vertex *parent = &vertices[call_stack[depth - 1]];
+                if (parent->acc_number > current->acc_number) parent->acc_number = current->acc_number;
+            }
+        }
+    }
+    free(vertices);
+    free(stack);
+    free(call_stack);
+    free(iterators);
+    return partition;
+}
+
+// Function that computes one step next = current * P directly on the compressed graph
+void step_distribution_compressed(const t_compressed_graph *compressed, const float *current, float *next) {
+    t_edge_iterator it;
+    for (int v = 0; v < compressed->size; v++) next[v] = 0;
+    for (int v = 0; v < compressed->size; v++) {
+        float mass = current[v];
+        if (mass == 0) continue;
+        compressed_edges(compressed, v, &it);
+        while (next_edge(&it)) next[it.arr - 1] += mass * it.proba;
+    }
+}
@@ -0,0 +1,56 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef COMPRESSED_H
+#define COMPRESSED_H
+#include <stdint.h>
+#include "functions.h"
+
+// Storage of the probabilities in a compressed graph
+typedef enum {
+    PROBA_FLOAT,    // 32-bit float, exact
+    PROBA_FIXED16,  // 16-bit fixed point p * 65535, absolute error <= 1 / 131070 (about 7.6e-6),
+                    // only for probabilities in [0, 1]
+    PROBA_HALF      // 16-bit half float, relative error <= 2^-11 (about 4.9e-4) above 6.1e-5,
+                    // absolute error <= 2^-25 below
+} t_proba_encoding;
+
+// Read-only compressed graph. The edges of each vertex are one byte stream:
+// varint(number of edges), then for each edge varint(target - previous target) and its probability
+typedef struct {
+    int size;                   // Number of vertices
+    int nb_edges;               // Number of edges
+    t_proba_encoding encoding;  // Storage of the probabilities
+    uint64_t *offsets;          // Start of the stream of each vertex in data (size + 1 entries)
+    unsigned char *data;        // Streams of all the vertices, one after the other
+} t_compressed_graph;
+
+// Iterator over the edges of one vertex
+typedef struct {
+    const unsigned char *cursor;    // Next byte to decode
+    int remaining;                  // Edges not decoded yet
+    t_proba_encoding encoding;      // Storage of the probabilities
+    int arr;                        // Target of the current edge (1-based, like cell.arr)
+    float proba;                    // Probability of the current edge
+} t_edge_iterator;
+
+t_compressed_graph* compress_graph(const a_list *, t_proba_encoding);
+
+void free_compressed_graph(t_compressed_graph *);
+
+void compressed_edges(const t_compressed_graph *, int, t_edge_iterator *);
+
+int next_edge(t_edge_iterator *);
+
+size_t compressed_graph_memory(const t_compressed_graph *);
+
+size_t a_list_memory(const a_list *);
+
+a_list decompress_graph(const t_compressed_graph *);
+
+t_partition compute_partition_compressed(const t_compressed_graph *);
+
+void step_distribution_compressed(const t_compressed_graph *, const float *, float *);
+
+#endif //COMPRESSED_H
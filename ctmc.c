@@ -0,0 +1,182 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "ctmc.h"
+
+// Continuous-time chains: the graph holds the rates q(i,j) read with the rates option, and the exit
+// rate of a state is q(i) = sum of its rates.
+// The classes are those of the embedded (jump) chain P(i,j) = q(i,j) / q(i), which has the same
+// edges, so compute_partition and classify_graph are used on it unchanged.
+// Transient distribution by uniformisation: with L >= every q(i), P = I + Q / L is stochastic and
+//     pi(t) = sum_k Poisson(k; L.t) pi(0) P^k
+// so pi(t) only needs products by the sparse P. The Poisson weights are truncated the Fox-Glynn
+// way: computed from the mode outwards (w(mode) = 1, so they neither underflow nor overflow) and
+// cut on each side as soon as a geometric bound on the rest of the tail falls below epsilon / 2 of
+// the weight kept, so the number of products depends only on L.t and the accuracy asked for.
+// When a product leaves the vector exactly unchanged, it is a fixed point of P: the remaining weights
+// are given to it instead of doing more products. A small or shrinking change is not enough, a slow
+// transition can still move all the mass long after the fast ones have settled.
+
+
+// Function that builds the embedded jump chain of a rate graph (states without rates become absorbing)
+a_list embedded_chain(const a_list *rates) {
+    a_list *chain = create_a_list(rates->size);
+    for (int v = 0; v < rates->size; v++) {
+        double exit_rate = 0;
+        for (cell *e = rates->array[v].head; e != NULL; e = e->next) exit_rate += e->proba;
+        if (exit_rate <= 0) {
+            insert_cell(&chain->array[v], v + 1, 1);
+            continue;
+        }
+        for (cell *e = rates->array[v].head; e != NULL; e = e->next) {
+            insert_cell(&chain->array[v], e->arr, (float)(e->proba / exit_rate));
+        }
+    }
+    a_list result = *chain;
+    free(chain);
+    return result;
+}
+
+// Poisson weights of parameter lambda between the truncation points left and right (unnormalised,
+// their sum is stored in total). Returns NULL if the memory runs out
+static double* poisson_weights(double lambda, double epsilon, int *left, int *right, double *total) {
+    int mode = (int)lambda;
+    double kept = 1;
+    // left point: the ratio w(k-1) / w(k) = k / lambda only decreases below the mode
+    int low = mode;
+    double weight = 1;
+    while (low > 0) {
+        double ratio = low / lambda;
+        if (ratio < 1 && weight * ratio / (1 - ratio) <= epsilon / 2 * kept) break;
+        weight *= ratio;
+        kept += weight;
+        low--;
+    }
+    // right point: the ratio w(k+1) / w(k) = lambda / (k + 1) only decreases above the mode
+    int high = mode;
+    weight = 1;
+    for (;;) {
+        double ratio = lambda / (high + 1);
+        if (ratio < 1 && weight * ratio / (1 - ratio) <= epsilon / 2 * kept) break;
+        weight *= ratio;
+        kept += weight;
+        high++;
+    }
+    double *weights = malloc((high - low + 1) * sizeof(double));
+    if (weights == NULL) return NULL;
+    // same recurrences again, now stored
+    weights[mode - low] = 1;
+    for (int k = mode; k > low; k--) weights[k - 1 - low] = weights[k - low] * (k / lambda);
+    for (int k = mode; k < high; k++) weights[k + 1 - low] = weights[k - low] * (lambda / (k + 1));
+    *total = 0;
+    for (int k = 0; k <= high - low; k++) *total += weights[k];
+    *left = low;
+    *right = high;
+    return weights;
+}
+
+// y = x (I + Q / rate) on the sparse rate graph
+static void uniformised_step(const a_list *rates, const double *exit_rates, double rate, const double *x, double *y) {
+    int n = rates->size;
+    for (int j = 0; j < n; j++) y[j] = x[j] * (1 - exit_rates[j] / rate);
+    for (int i = 0; i < n; i++) {
+        double flow = x[i] / rate;
+        if (flow == 0) continue;
+        for (cell *e = rates->array[i].head; e != NULL; e = e->next) y[e->arr - 1] += flow * e->proba;
+    }
+}
+
+// Function that computes the distribution at time t of a continuous-time chain given by its rates,
+// starting from the initial distribution, to within epsilon in total variation
+t_ctmc_transient* ctmc_transient(const a_list *rates, const double *initial, double time, double epsilon) {
+    if (rates == NULL || rates->array == NULL || initial == NULL || time < 0 || epsilon <= 0 || epsilon >= 1) {
+        fprintf(stderr, "Error: Invalid input for the transient solver (sorry ;()\n");
+        return NULL;
+    }
+    int n = rates->size;
+    t_ctmc_transient *result = calloc(1, sizeof(t_ctmc_transient));
+    double *exit_rates = malloc((n > 0 ? n : 1) * sizeof(double));
+    double *current = malloc((n > 0 ? n : 1) * sizeof(double));
+    double *next = malloc((n > 0 ? n : 1) * sizeof(double));
+    if (result == NULL || exit_rates == NULL || current == NULL || next == NULL) {
+        fprintf(stderr, "Memory allocation error for transient solver (sorry ;()\n");
+        free(result);
+        free(exit_rates);
+        free(current);
+        free(next);
+        return NULL;
+    }
+    result->size = n;
+    result->time = time;
+    result->distribution = calloc(n > 0 ? n : 1, sizeof(double));
+    double rate = 0;
+    for (int v = 0; v < n; v++) {
+        exit_rates[v] = 0;
+        for (cell *e = rates->array[v].head; e != NULL; e = e->next) exit_rates[v] += e->proba;
+        if (exit_rates[v] > rate) rate = exit_rates[v];
+    }
+    result->rate = rate;
+    double total = 1;
+    double *weights = NULL;
+    if (rate > 0 && time > 0) {
+        weights = poisson_weights(rate * time, epsilon, &result->left, &result->right, &total);
+    } else {
+        // nothing moves: pi(t) = pi(0)
+        weights = malloc(sizeof(double));
+        if (weights != NULL) weights[0] = 1;
+    }
+    if (weights == NULL || result->distribution == NULL) {
+        fprintf(stderr, "Memory allocation error for transient solver (sorry ;()\n");
+        free(weights);
+        free(exit_rates);
+        free(current);
+        free(next);
+        free_ctmc_transient(result);
+        return NULL;
+    }
+    for (int v = 0; v < n; v++) current[v] = initial[v];
+    for (int k = 0; k <= result->right; k++) {
+        if (k >= result->left) {
+            double w = weights[k - result->left];
+            for (int v = 0; v < n; v++) result->distribution[v] += w * current[v];
+        }
+        if (k == result->right) break;
+        uniformised_step(rates, exit_rates, rate, current, next);
+        result->nb_products++;
+        int settled = 1;
+        for (int v = 0; v < n && settled; v++) settled = (next[v] == current[v]);
+        double *swap = current;
+        current = next;
+        next = swap;
+        if (settled) {
+            // steady state: every remaining term uses this vector
+            double remaining = 0;
+            for (int j = (k + 1 > result->left ? k + 1 : result->left); j <= result->right; j++) {
+                remaining += weights[j - result->left];
+            }
+            for (int v = 0; v < n; v++) result->distribution[v] += remaining * current[v];
+            break;
+        }
+    }
+    for (int v = 0; v < n; v++) result->distribution[v] /= total;
+    free(weights);
+    free(exit_rates);
+    free(current);
+    free(next);
+    return result;
+}
+
+// Function that displays a transient distribution
+void display_ctmc_transient(const t_ctmc_transient *result) {
+    printf("pi(%.4f) with uniformisation rate %.4f, Poisson terms %d..%d, %d products:\n", result->time, result->rate,
+           result->left, result->right, result->nb_products);
+    for (int v = 0; v < result->size; v++) printf("  State %d: %.6f\n", v + 1, result->distribution[v]);
+}
+
+// Function that frees a transient distribution
+void free_ctmc_transient(t_ctmc_transient *result) {
+    if (result == NULL) return;
+    free(result->distribution);
+    free(result);
+}
@@ -0,0 +1,28 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef CTMC_H
+#define CTMC_H
+#include "functions.h"
+
+// Distribution of a continuous-time chain at one time, computed by uniformisation
+typedef struct {
+    int size;               // Number of states
+    double time;            // Time t of the distribution
+    double rate;            // Uniformisation rate (largest exit rate)
+    int left;               // First Poisson term kept (Fox-Glynn left truncation point)
+    int right;              // Last Poisson term kept (right truncation point)
+    int nb_products;        // Vector-matrix products done (fewer than right when the chain settles)
+    double *distribution;   // pi(t)
+} t_ctmc_transient;
+
+a_list embedded_chain(const a_list *);
+
+t_ctmc_transient* ctmc_transient(const a_list *, const double *, double, double);
+
+void display_ctmc_transient(const t_ctmc_transient *);
+
+void free_ctmc_transient(t_ctmc_transient *);
+
+#endif //CTMC_H
@@ -0,0 +1,205 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "diff.h"
+
+// Diff of two versions of a chain without building any matrix: the rows of both graphs are sorted
+// by target (block lists always are, linked lists are copied and sorted first), so each pair of rows
+// is merged like two sorted lists. The whole diff costs one visit of every edge of both versions
+// (plus one test per empty row), instead of the n^2 scan of matrix_difference on dense matrices,
+// and gives the same L1 distance.
+// Class changes: a class of the old partition is unchanged when all its vertices are in the same
+// class of the new one and both classes have the same size; the vertices of every other class moved.
+
+
+#define DIFF_DISPLAY_LIMIT 20
+
+// Cells of a row in increasing target order, copied into scratch when the row is a linked list
+static const cell* sorted_row(const list *row, cell **scratch, int *scratch_capacity, int *failed) {
+    if (row->head == NULL || row->capacity > 0) return row->head;
+    if (row->size > *scratch_capacity) {
+        cell *grown = realloc(*scratch, row->size * sizeof(cell));
+        if (grown == NULL) {
+            *failed = 1;
+            return NULL;
+        }
+        *scratch = grown;
+        *scratch_capacity = row->size;
+    }
+    int k = 0;
+    for (cell *e = row->head; e != NULL; e = e->next) (*scratch)[k++] = *e;
+    qsort(*scratch, k, sizeof(cell), compare_cells);
+    return *scratch;
+}
+
+static void add_edge_change(t_chain_diff *diff, int *capacity, int *failed, int from, int to,
+                            t_edge_change_kind kind, float before, float after) {
+    if (diff->nb_edges >= *capacity) {
+        int grown_capacity = (*capacity > 0) ? 2 * *capacity : 64;
+        t_edge_change *grown = realloc(diff->edges, grown_capacity * sizeof(t_edge_change));
+        if (grown == NULL) {
+            *failed = 1;
+            return;
+        }
+        diff->edges = grown;
+        *capacity = grown_capacity;
+    }
+    t_edge_change change = {from, to, kind, before, after};
+    diff->edges[diff->nb_edges++] = change;
+    diff->counts[kind]++;
+}
+
+static void add_row_change(t_chain_diff *diff, int *capacity, int *failed, int vertex, float max_change) {
+    if (diff->nb_rows >= *capacity) {
+        int grown_capacity = (*capacity > 0) ? 2 * *capacity : 64;
+        t_row_change *grown = realloc(diff->rows, grown_capacity * sizeof(t_row_change));
+        if (grown == NULL) {
+            *failed = 1;
+            return;
+        }
+        diff->rows = grown;
+        *capacity = grown_capacity;
+    }
+    t_row_change change = {vertex, max_change};
+    diff->rows[diff->nb_rows++] = change;
+}
+
+// Vertices whose class is not the same set of vertices in both partitions
+static int find_moved_vertices(t_chain_diff *diff, t_partition *before, t_partition *after) {
+    int n = (diff->size_before > diff->size_after) ? diff->size_before : diff->size_after;
+    int *class_after = create_vertex_to_class(after, diff->size_after);
+    char *moved = calloc(n > 0 ? n : 1, 1);
+    diff->moved = malloc((n > 0 ? n : 1) * sizeof(int));
+    if (class_after == NULL || moved == NULL || diff->moved == NULL) {
+        free(class_after);
+        free(moved);
+        return 0;
+    }
+    for (int v = diff->size_before; v < diff->size_after; v++) moved[v] = 1;  // new vertices
+    for (int c = 0; c < before->size; c++) {
+        const t_class *class = &before->classes[c];
+        int first = class->vertices[0].identifier;
+        int d = (first < diff->size_after) ? class_after[first] : -1;
+        int same = (d >= 0 && after->classes[d].size == class->size);
+        for (int i = 0; i < class->size && same; i++) {
+            int v = class->vertices[i].identifier;
+            same = (v < diff->size_after && class_after[v] == d);
+        }
+        if (!same) {
+            for (int i = 0; i < class->size; i++) moved[class->vertices[i].identifier] = 1;
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        if (moved[v]) diff->moved[diff->nb_moved++] = v + 1;
+    }
+    free(class_after);
+    free(moved);
+    return 1;
+}
+
+// Function that compares two versions of a chain edge by edge
+// Reweightings of at most tolerance are left out of the list (they still count in the distance);
+// the partitions are optional (NULL for no class comparison)
+t_chain_diff* diff_chains(const a_list *before, const a_list *after, t_partition *partition_before,
+                          t_partition *partition_after, float tolerance) {
+    if (before == NULL || after == NULL || before->array == NULL || after->array == NULL) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return NULL;
+    }
+    t_chain_diff *diff = calloc(1, sizeof(t_chain_diff));
+    if (diff == NULL) {
+        fprintf(stderr, "Memory allocation error for chain diff (sorry ;()\n");
+        return NULL;
+    }
+    diff->size_before = before->size;
+    diff->size_after = after->size;
+    int n = (before->size > after->size) ? before->size : after->size;
+    cell *scratch_before = NULL;
+    cell *scratch_after = NULL;
+    int capacity_before = 0;
+    int capacity_after = 0;
+    int edges_capacity = 0;
+    int rows_capacity = 0;
+    int failed = 0;
+    list empty_row = {NULL, 0, 0};
+    double distance = 0;
+    for (int v = 0; v < n && !failed; v++) {
+        const list *row_before = (v < before->size) ? &before->array[v] : &empty_row;
+        const list *row_after = (v < after->size) ? &after->array[v] : &empty_row;
+        if (row_before->head == NULL && row_after->head == NULL) continue;
+        const cell *old_cells = sorted_row(row_before, &scratch_before, &capacity_before, &failed);
+        const cell *new_cells = sorted_row(row_after, &scratch_after, &capacity_after, &failed);
+        if (failed) break;
+        int i = 0;
+        int j = 0;
+        float max_change = 0;
+        int changed = 0;
+        while (i < row_before->size || j < row_after->size) {
+            int old_target = (i < row_before->size) ? old_cells[i].arr : -1;
+            int new_target = (j < row_after->size) ? new_cells[j].arr : -1;
+            float old_proba = 0;
+            float new_proba = 0;
+            t_edge_change_kind kind;
+            int to;
+            if (new_target == -1 || (old_target != -1 && old_target < new_target)) {
+                to = old_target;
+                old_proba = old_cells[i++].proba;
+                kind = EDGE_REMOVED;
+            } else if (old_target == -1 || new_target < old_target) {
+                to = new_target;
+                new_proba = new_cells[j++].proba;
+                kind = EDGE_ADDED;
+            } else {
+                to = old_target;
+                old_proba = old_cells[i++].proba;
+                new_proba = new_cells[j++].proba;
+                kind = EDGE_REWEIGHTED;
+            }
+            float change = new_proba - old_proba;
+            if (change < 0) change = -change;
+            distance += change;
+            if (change > max_change) max_change = change;
+            if (kind != EDGE_REWEIGHTED || change > tolerance) {
+                add_edge_change(diff, &edges_capacity, &failed, v + 1, to, kind, old_proba, new_proba);
+                changed = 1;
+            }
+        }
+        if (changed) add_row_change(diff, &rows_capacity, &failed, v + 1, max_change);
+    }
+    free(scratch_before);
+    free(scratch_after);
+    diff->l1_distance = distance;
+    if (!failed && partition_before != NULL && partition_after != NULL) {
+        failed = !find_moved_vertices(diff, partition_before, partition_after);
+    }
+    if (failed) {
+        fprintf(stderr, "Memory allocation error for chain diff (sorry ;()\n");
+        free_chain_diff(diff);
+        return NULL;
+    }
+    return diff;
+}
+
+// Function that displays a chain diff (its first changes only when there are many)
+void display_chain_diff(const t_chain_diff *diff) {
+    static const char *kinds[NB_EDGE_CHANGES] = {"added", "removed", "reweighted"};
+    for (int k = 0; k < diff->nb_edges && k < DIFF_DISPLAY_LIMIT; k++) {
+        const t_edge_change *change = &diff->edges[k];
+        printf("  %d -> %d %s (%.4f -> %.4f)\n", change->from, change->to, kinds[change->kind], change->before,
+               change->after);
+    }
+    if (diff->nb_edges > DIFF_DISPLAY_LIMIT) printf("  ... %d more\n", diff->nb_edges - DIFF_DISPLAY_LIMIT);
+    printf("%d added, %d removed, %d reweighted edge(s) in %d row(s), L1 distance %.4f\n", diff->counts[EDGE_ADDED],
+           diff->counts[EDGE_REMOVED], diff->counts[EDGE_REWEIGHTED], diff->nb_rows, diff->l1_distance);
+    if (diff->moved != NULL) printf("%d vertex/vertices changed class\n", diff->nb_moved);
+}
+
+// Function that frees a chain diff
+void free_chain_diff(t_chain_diff *diff) {
+    if (diff == NULL) return;
+    free(diff->edges);
+    free(diff->rows);
+    free(diff->moved);
+    free(diff);
+}
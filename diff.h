@@ -0,0 +1,52 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef DIFF_H
+#define DIFF_H
+#include "functions.h"
+
+// Kind of change of one edge between two versions of a chain
+typedef enum {
+    EDGE_ADDED,         // Only in the new version
+    EDGE_REMOVED,       // Only in the old version
+    EDGE_REWEIGHTED,    // In both, with a different probability
+    NB_EDGE_CHANGES
+} t_edge_change_kind;
+
+// One changed edge
+typedef struct {
+    int from;           // 1-based vertices
+    int to;
+    t_edge_change_kind kind;
+    float before;       // Probability in the old version (0 if added)
+    float after;        // Probability in the new version (0 if removed)
+} t_edge_change;
+
+// Largest change in one row that changed
+typedef struct {
+    int vertex;         // 1-based vertex
+    float max_change;   // Largest |after - before| over the edges of the row
+} t_row_change;
+
+// Differences between two versions of a chain
+typedef struct {
+    int size_before;                // Number of vertices of each version
+    int size_after;
+    double l1_distance;             // Sum of |after - before| over all edges (matrix_difference)
+    t_edge_change *edges;           // Changed edges, by row then by target
+    int nb_edges;
+    int counts[NB_EDGE_CHANGES];    // Number of changed edges of each kind
+    t_row_change *rows;             // Rows with at least one change, in increasing order
+    int nb_rows;
+    int *moved;                     // Vertices whose class changed (1-based), when partitions are given
+    int nb_moved;
+} t_chain_diff;
+
+t_chain_diff* diff_chains(const a_list *, const a_list *, t_partition *, t_partition *, float);
+
+void display_chain_diff(const t_chain_diff *);
+
+void free_chain_diff(t_chain_diff *);
+
+#endif //DIFF_H
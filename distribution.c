@@ -0,0 +1,163 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "distribution.h"
+
+// Transient distributions computed on the adjacency list: one step costs O(E) and the
+// n x n transition matrix is never built.
+// Several distributions can be advanced together as an n x k row-major panel: each edge is
+// then read once for the k distributions, and the k products go through SIMD lanes.
+
+
+// Function that computes one step next = current * P by pushing each probability along the edges
+void step_distribution(a_list *graph, const float *current, float *next) {
+    for (int v = 0; v < graph->size; v++) next[v] = 0;
+    for (int v = 0; v < graph->size; v++) {
+        float mass = current[v];
+        if (mass == 0) continue;  // nothing to push
+        for (cell *c = graph->array[v].head; c != NULL; c = c->next) {
+            next[c->arr - 1] += mass * c->proba;
+        }
+    }
+}
+
+// Function that computes one step for k distributions stored as an n x k row-major panel
+// Each lane gets exactly the operations of step_distribution, so the results are identical
+void step_distribution_block(a_list *graph, const float *current, float *next, int k) {
+    if (k == 1) {
+        step_distribution(graph, current, next);
+        return;
+    }
+    size_t panel = (size_t)graph->size * k;
+    for (size_t i = 0; i < panel; i++) next[i] = 0;
+    for (int v = 0; v < graph->size; v++) {
+        const float *restrict source = &current[(size_t)v * k];
+        for (cell *c = graph->array[v].head; c != NULL; c = c->next) {
+            float proba = c->proba;  // loaded once for the k lanes
+            float *restrict destination = &next[(size_t)(c->arr - 1) * k];
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+            for (int j = 0; j < k; j++) {
+                destination[j] += source[j] * proba;
+            }
+        }
+    }
+}
+
+static int compare_long_longs(const void *a, const void *b) {
+    long long x = *(const long long *)a;
+    long long y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+// Function that advances an initial distribution and keeps a copy of it at each requested time
+// The times can be given in any order, the vector is only advanced up to the largest one
+t_distribution_snapshots* evolve_distribution(a_list *graph, const float *initial, const int *times, int nb_times) {
+    return evolve_distribution_block(graph, initial, 1, times, nb_times);
+}
+
+// Function that advances k initial distributions together (n x k row-major panel)
+t_distribution_snapshots* evolve_distribution_block(a_list *graph, const float *initial, int nb_vectors,
+                                                    const int *times, int nb_times) {
+    if (graph == NULL || graph->array == NULL || initial == NULL || nb_vectors < 1 ||
+        (nb_times > 0 && times == NULL)) {
+        fprintf(stderr, "Error: Invalid distribution input (sorry ;()\n");
+        return NULL;
+    }
+    int n = graph->size;
+    size_t panel = (size_t)n * nb_vectors;  // number of floats of one panel
+    int max_time = 0;
+    for (int k = 0; k < nb_times; k++) {
+        if (times[k] < 0) {
+            fprintf(stderr, "Error: Time %d is negative\n", times[k]);
+            return NULL;
+        }
+        if (times[k] > max_time) max_time = times[k];
+    }
+    t_distribution_snapshots *result = malloc(sizeof(t_distribution_snapshots));
+    float *current = malloc(panel * sizeof(float));
+    float *next = malloc(panel * sizeof(float));
+    if (result == NULL || current == NULL || next == NULL) {
+        fprintf(stderr, "Memory allocation error for distributions (sorry ;()\n");
+        free(result);
+        free(current);
+        free(next);
+        return NULL;
+    }
+    result->size = n;
+    result->nb_vectors = nb_vectors;
+    result->nb_times = nb_times;
+    result->times = malloc(nb_times * sizeof(int));
+    result->snapshots = calloc(nb_times, sizeof(float *));
+    int failed = (nb_times > 0 && (result->times == NULL || result->snapshots == NULL));
+    for (int k = 0; k < nb_times && !failed; k++) {
+        result->times[k] = times[k];
+        result->snapshots[k] = malloc(panel * sizeof(float));
+        if (result->snapshots[k] == NULL) failed = 1;
+    }
+    if (failed) {
+        fprintf(stderr, "Memory allocation error for distributions (sorry ;()\n");
+        free(current);
+        free(next);
+        free_distribution_snapshots(result);
+        return NULL;
+    }
+    // snapshots sorted by time (time in the high bits, request index in the low bits)
+    long long *pending = malloc(nb_times * sizeof(long long));
+    if (nb_times > 0 && pending == NULL) {
+        fprintf(stderr, "Memory allocation error for distributions (sorry ;()\n");
+        free(current);
+        free(next);
+        free_distribution_snapshots(result);
+        return NULL;
+    }
+    for (int k = 0; k < nb_times; k++) pending[k] = ((long long)times[k] << 32) | k;
+    qsort(pending, nb_times, sizeof(long long), compare_long_longs);
+    memcpy(current, initial, panel * sizeof(float));
+    int next_snapshot = 0;
+    for (int t = 0; t <= max_time; t++) {
+        while (next_snapshot < nb_times && (pending[next_snapshot] >> 32) == t) {
+            int k = (int)(pending[next_snapshot++] & 0xFFFFFFFFLL);
+            memcpy(result->snapshots[k], current, panel * sizeof(float));
+        }
+        if (t == max_time) break;
+        step_distribution_block(graph, current, next, nb_vectors);
+        float *swap = current;  // the next vector becomes the current one
+        current = next;
+        next = swap;
+    }
+    free(pending);
+    free(current);
+    free(next);
+    return result;
+}
+
+// Function that displays the snapshots, one line per time
+void display_distribution_snapshots(const t_distribution_snapshots *snapshots) {
+    for (int k = 0; k < snapshots->nb_times; k++) {
+        for (int j = 0; j < snapshots->nb_vectors; j++) {
+            if (snapshots->nb_vectors > 1) {
+                printf("t = %d, distribution %d:", snapshots->times[k], j + 1);
+            } else {
+                printf("t = %d:", snapshots->times[k]);
+            }
+            for (int v = 0; v < snapshots->size; v++) {
+                printf(" %.4f", snapshots->snapshots[k][(size_t)v * snapshots->nb_vectors + j]);
+            }
+            printf("\n");
+        }
+    }
+}
+
+// Function that frees the snapshots
+void free_distribution_snapshots(t_distribution_snapshots *snapshots) {
+    if (snapshots == NULL) return;
+    if (snapshots->snapshots != NULL) {
+        for (int k = 0; k < snapshots->nb_times; k++) free(snapshots->snapshots[k]);
+    }
+    free(snapshots->snapshots);
+    free(snapshots->times);
+    free(snapshots);
+}
@@ -0,0 +1,31 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef DISTRIBUTION_H
+#define DISTRIBUTION_H
+#include "functions.h"
+
+// Distributions pi_t = pi_0 P^t taken at several times
+typedef struct {
+    int size;           // Number of vertices
+    int nb_vectors;     // Number of distributions advanced together
+    int nb_times;       // Number of snapshots
+    int *times;         // Time (number of steps) of each snapshot, in the order requested
+    float **snapshots;  // snapshots[k][v * nb_vectors + j] = probability for distribution j
+                        // to be at vertex v+1 after times[k] steps
+} t_distribution_snapshots;
+
+void step_distribution(a_list *, const float *, float *);
+
+void step_distribution_block(a_list *, const float *, float *, int);
+
+t_distribution_snapshots* evolve_distribution(a_list *, const float *, const int *, int);
+
+t_distribution_snapshots* evolve_distribution_block(a_list *, const float *, int, const int *, int);
+
+void display_distribution_snapshots(const t_distribution_snapshots *);
+
+void free_distribution_snapshots(t_distribution_snapshots *);
+
+#endif //DISTRIBUTION_H
@@ -0,0 +1,628 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "dynamic.h"
+
+// Dynamic mode: the partition, the class links and the transient/persistent flags are
+// updated after each edge operation instead of rerunning compute_partition and Hasse.
+// Classes are kept in a topological order (every class link goes to a higher position):
+// - an insertion that follows the order only adds a link,
+// - an insertion against the order either reorders the classes between its two ends
+//   (Pearce-Kelly) or, when it closes a cycle, merges the classes lying on that cycle,
+// - a deletion inside a class reruns Tarjan on that class only and splits it if needed.
+
+
+static void dynamic_alloc_error(void) {
+    fprintf(stderr, "Memory allocation error in dynamic graph (Never sure how that happens honestly. Unfreed memory? Problem with the engine? Take your guess :p)\n");
+    exit(EXIT_FAILURE);
+}
+
+// Find the position of a class in a link list (-1 if absent)
+static int adj_find(const t_class_adj *adj, int target) {
+    for (int i = 0; i < adj->size; i++) {
+        if (adj->targets[i] == target) return i;
+    }
+    return -1;
+}
+
+// Add count edges to the link towards target (creating it if needed)
+static void adj_add(t_class_adj *adj, int target, int count) {
+    int i = adj_find(adj, target);
+    if (i >= 0) {
+        adj->counts[i] += count;
+        return;
+    }
+    if (adj->size >= adj->capacity) {
+        adj->capacity = (adj->capacity == 0) ? 4 : adj->capacity * 2;
+        adj->targets = realloc(adj->targets, adj->capacity * sizeof(int));
+        adj->counts = realloc(adj->counts, adj->capacity * sizeof(int));
+        if (adj->targets == NULL || adj->counts == NULL) dynamic_alloc_error();
+    }
+    adj->targets[adj->size] = target;
+    adj->counts[adj->size] = count;
+    adj->size++;
+}
+
+// Remove count edges from the link towards target, dropping the link when none remain
+// (a count of -1 drops the link whatever its count)
+static void adj_sub(t_class_adj *adj, int target, int count) {
+    int i = adj_find(adj, target);
+    if (i < 0) return;
+    if (count >= 0) adj->counts[i] -= count;
+    if (count < 0 || adj->counts[i] <= 0) {
+        // replace the removed link with the last one
+        adj->size--;
+        adj->targets[i] = adj->targets[adj->size];
+        adj->counts[i] = adj->counts[adj->size];
+    }
+}
+
+// Rename a linked class (used when a class changes index)
+static void adj_rename(t_class_adj *adj, int old_target, int new_target) {
+    int i = adj_find(adj, old_target);
+    if (i >= 0) adj->targets[i] = new_target;
+}
+
+static void link_add(t_dynamic_graph *dg, int from, int to, int count) {
+    adj_add(&dg->out_links[from], to, count);
+    adj_add(&dg->in_links[to], from, count);
+}
+
+static void link_sub(t_dynamic_graph *dg, int from, int to, int count) {
+    adj_sub(&dg->out_links[from], to, count);
+    adj_sub(&dg->in_links[to], from, count);
+}
+
+// Add a vertex to a class, growing its array if needed
+static void class_append(t_class *c, t_tarjan_vertex v) {
+    if (c->size >= c->capacity) {
+        c->capacity = (c->capacity == 0) ? 4 : c->capacity * 2;
+        c->vertices = realloc(c->vertices, c->capacity * sizeof(t_tarjan_vertex));
+        if (c->vertices == NULL) dynamic_alloc_error();
+    }
+    c->vertices[c->size++] = v;
+}
+
+// Make room for one more class in every per-class array
+static void ensure_class_capacity(t_dynamic_graph *dg, int needed) {
+    if (needed > dg->partition.capacity) {
+        int capacity = (dg->partition.capacity == 0) ? 4 : dg->partition.capacity;
+        while (capacity < needed) capacity *= 2;
+        dg->partition.classes = realloc(dg->partition.classes, capacity * sizeof(t_class));
+        if (dg->partition.classes == NULL) dynamic_alloc_error();
+        dg->partition.capacity = capacity;
+    }
+    if (needed <= dg->class_capacity) return;
+    int capacity = (dg->class_capacity == 0) ? 4 : dg->class_capacity;
+    while (capacity < needed) capacity *= 2;
+    dg->out_links = realloc(dg->out_links, capacity * sizeof(t_class_adj));
+    dg->in_links = realloc(dg->in_links, capacity * sizeof(t_class_adj));
+    dg->position = realloc(dg->position, capacity * sizeof(int));
+    dg->order = realloc(dg->order, capacity * sizeof(int));
+    dg->mark_f = realloc(dg->mark_f, capacity * sizeof(int));
+    dg->mark_b = realloc(dg->mark_b, capacity * sizeof(int));
+    if (dg->out_links == NULL || dg->in_links == NULL || dg->position == NULL ||
+        dg->order == NULL || dg->mark_f == NULL || dg->mark_b == NULL) {
+        dynamic_alloc_error();
+    }
+    for (int c = dg->class_capacity; c < capacity; c++) {
+        dg->out_links[c] = (t_class_adj){NULL, NULL, 0, 0};
+        dg->in_links[c] = (t_class_adj){NULL, NULL, 0, 0};
+        dg->mark_f[c] = 0;
+        dg->mark_b[c] = 0;
+    }
+    dg->class_capacity = capacity;
+}
+
+// Create an empty class at the end of the partition and return its index
+static int new_class_slot(t_dynamic_graph *dg) {
+    ensure_class_capacity(dg, dg->partition.size + 1);
+    int k = dg->partition.size++;
+    t_class *c = &dg->partition.classes[k];
+    c->name = malloc(13 * sizeof(char));
+    if (c->name == NULL) dynamic_alloc_error();
+    snprintf(c->name, 13, "C%d", dg->next_name++);
+    c->vertices = NULL;
+    c->size = 0;
+    c->capacity = 0;
+    return k;
+}
+
+// Delete an emptied class (no vertices, no links) by moving the last class into its slot
+static void remove_class_slot(t_dynamic_graph *dg, int k) {
+    int last = dg->partition.size - 1;
+    free(dg->partition.classes[k].name);
+    free(dg->partition.classes[k].vertices);
+    free(dg->out_links[k].targets);
+    free(dg->out_links[k].counts);
+    free(dg->in_links[k].targets);
+    free(dg->in_links[k].counts);
+    if (k != last) {
+        t_class *moved = &dg->partition.classes[last];
+        for (int v = 0; v < moved->size; v++) {
+            dg->vertex_to_class[moved->vertices[v].identifier] = k;
+        }
+        for (int i = 0; i < dg->out_links[last].size; i++) {
+            adj_rename(&dg->in_links[dg->out_links[last].targets[i]], last, k);
+        }
+        for (int i = 0; i < dg->in_links[last].size; i++) {
+            adj_rename(&dg->out_links[dg->in_links[last].targets[i]], last, k);
+        }
+        dg->partition.classes[k] = *moved;
+        dg->out_links[k] = dg->out_links[last];
+        dg->in_links[k] = dg->in_links[last];
+        dg->position[k] = dg->position[last];
+        dg->mark_f[k] = dg->mark_f[last];
+        dg->mark_b[k] = dg->mark_b[last];
+    }
+    dg->out_links[last] = (t_class_adj){NULL, NULL, 0, 0};
+    dg->in_links[last] = (t_class_adj){NULL, NULL, 0, 0};
+    dg->partition.size--;
+}
+
+// Rebuild the order array from the positions, closing the gaps left by merged classes
+static void renumber_positions(t_dynamic_graph *dg) {
+    int nb = dg->partition.size;
+    int max_pos = -1;
+    for (int c = 0; c < nb; c++) {
+        if (dg->position[c] > max_pos) max_pos = dg->position[c];
+    }
+    int *slots = malloc((max_pos + 1) * sizeof(int));
+    if (slots == NULL && max_pos >= 0) dynamic_alloc_error();
+    for (int p = 0; p <= max_pos; p++) slots[p] = -1;
+    for (int c = 0; c < nb; c++) slots[dg->position[c]] = c;
+    int next = 0;
+    for (int p = 0; p <= max_pos; p++) {
+        if (slots[p] >= 0) {
+            dg->position[slots[p]] = next;
+            dg->order[next] = slots[p];
+            next++;
+        }
+    }
+    free(slots);
+}
+
+static int compare_ints(const void *a, const void *b) {
+    int x = *(const int *)a;
+    int y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+// Sort a list of classes by topological position (insertion sort, the lists are short)
+static void sort_by_position(const t_dynamic_graph *dg, int *classes, int count) {
+    for (int i = 1; i < count; i++) {
+        int c = classes[i];
+        int j = i - 1;
+        while (j >= 0 && dg->position[classes[j]] > dg->position[c]) {
+            classes[j + 1] = classes[j];
+            j--;
+        }
+        classes[j + 1] = c;
+    }
+}
+
+// Collect the classes reachable from start (forward) or reaching start (backward)
+// whose position stays inside [low_pos, high_pos]
+static int search_window(t_dynamic_graph *dg, int start, int forward, int low_pos, int high_pos,
+                         int *result) {
+    int *mark = forward ? dg->mark_f : dg->mark_b;
+    int count = 0;
+    int top = 0;
+    int *stack = malloc(dg->partition.size * sizeof(int));
+    if (stack == NULL) dynamic_alloc_error();
+    mark[start] = dg->stamp;
+    stack[top++] = start;
+    while (top > 0) {
+        int c = stack[--top];
+        result[count++] = c;
+        t_class_adj *adj = forward ? &dg->out_links[c] : &dg->in_links[c];
+        for (int i = 0; i < adj->size; i++) {
+            int next = adj->targets[i];
+            int pos = dg->position[next];
+            if (mark[next] != dg->stamp && pos >= low_pos && pos <= high_pos) {
+                mark[next] = dg->stamp;
+                stack[top++] = next;
+            }
+        }
+    }
+    free(stack);
+    return count;
+}
+
+// Merge the classes of the list into one class, returning the index of the survivor
+static int merge_classes(t_dynamic_graph *dg, int *members, int count) {
+    // keep the biggest class so that the fewest vertices are moved
+    int target = members[0];
+    for (int i = 1; i < count; i++) {
+        if (dg->partition.classes[members[i]].size > dg->partition.classes[target].size) {
+            target = members[i];
+        }
+    }
+    // members are recognised through a fresh mark
+    dg->stamp++;
+    for (int i = 0; i < count; i++) dg->mark_f[members[i]] = dg->stamp;
+    for (int i = 0; i < count; i++) {
+        int m = members[i];
+        if (m == target) continue;
+        t_class *from = &dg->partition.classes[m];
+        for (int v = 0; v < from->size; v++) {
+            dg->vertex_to_class[from->vertices[v].identifier] = target;
+            class_append(&dg->partition.classes[target], from->vertices[v]);
+        }
+        from->size = 0;
+        // redirect the links of m to the survivor, dropping the ones that became internal
+        t_class_adj *out = &dg->out_links[m];
+        for (int j = 0; j < out->size; j++) {
+            int t = out->targets[j];
+            adj_sub(&dg->in_links[t], m, -1);
+            if (dg->mark_f[t] != dg->stamp) link_add(dg, target, t, out->counts[j]);
+        }
+        out->size = 0;
+        t_class_adj *in = &dg->in_links[m];
+        for (int j = 0; j < in->size; j++) {
+            int s = in->targets[j];
+            adj_sub(&dg->out_links[s], m, -1);
+            if (dg->mark_f[s] != dg->stamp) link_add(dg, s, target, in->counts[j]);
+        }
+        in->size = 0;
+    }
+    // delete the emptied classes, highest index first so that the moved classes are never members
+    qsort(members, count, sizeof(int), compare_ints);
+    for (int i = count - 1; i >= 0; i--) {
+        int m = members[i];
+        if (m == target) continue;
+        if (dg->partition.size - 1 == target) target = m;  // the survivor is the class being moved
+        remove_class_slot(dg, m);
+    }
+    return target;
+}
+
+// Handle a new link from class x to class y that goes against the topological order
+static void insert_backward_link(t_dynamic_graph *dg, int x, int y) {
+    int low_pos = dg->position[y];
+    int high_pos = dg->position[x];
+    int *forward = malloc(dg->partition.size * sizeof(int));
+    int *backward = malloc(dg->partition.size * sizeof(int));
+    if (forward == NULL || backward == NULL) dynamic_alloc_error();
+    dg->stamp++;
+    int nb_forward = search_window(dg, y, 1, low_pos, high_pos, forward);
+    int nb_backward = search_window(dg, x, 0, low_pos, high_pos, backward);
+    int cycle = (dg->mark_f[x] == dg->stamp);
+    // pool of the positions of every class involved, handed out again in a valid order
+    int *pool = malloc((nb_forward + nb_backward) * sizeof(int));
+    int *cycle_members = malloc((nb_forward + nb_backward) * sizeof(int));
+    if (pool == NULL || cycle_members == NULL) dynamic_alloc_error();
+    int nb_pool = 0;
+    int nb_cycle = 0;
+    for (int i = 0; i < nb_backward; i++) pool[nb_pool++] = dg->position[backward[i]];
+    for (int i = 0; i < nb_forward; i++) {
+        if (dg->mark_b[forward[i]] == dg->stamp) {
+            cycle_members[nb_cycle++] = forward[i];  // on a path y -> ... -> x
+        } else {
+            pool[nb_pool++] = dg->position[forward[i]];
+        }
+    }
+    qsort(pool, nb_pool, sizeof(int), compare_ints);
+    // classes leading to x first, then the merged cycle, then the classes reached from y
+    int nb_b = 0;
+    for (int i = 0; i < nb_backward; i++) {
+        if (dg->mark_f[backward[i]] != dg->stamp) backward[nb_b++] = backward[i];
+    }
+    int nb_f = 0;
+    for (int i = 0; i < nb_forward; i++) {
+        if (dg->mark_b[forward[i]] != dg->stamp) forward[nb_f++] = forward[i];
+    }
+    sort_by_position(dg, backward, nb_b);
+    sort_by_position(dg, forward, nb_f);
+    for (int i = 0; i < nb_b; i++) dg->position[backward[i]] = pool[i];
+    for (int i = 0; i < nb_f; i++) dg->position[forward[i]] = pool[nb_pool - nb_f + i];
+    if (cycle) {
+        // the cycle classes all share one position, gaps are closed afterwards
+        for (int i = 0; i < nb_cycle; i++) dg->position[cycle_members[i]] = pool[nb_b];
+        int merged = merge_classes(dg, cycle_members, nb_cycle);
+        dg->position[merged] = pool[nb_b];
+        renumber_positions(dg);
+    } else {
+        for (int i = 0; i < nb_pool; i++) {
+            dg->order[pool[i]] = -1;
+        }
+        for (int i = 0; i < nb_b; i++) dg->order[dg->position[backward[i]]] = backward[i];
+        for (int i = 0; i < nb_f; i++) dg->order[dg->position[forward[i]]] = forward[i];
+        link_add(dg, x, y, 1);
+    }
+    free(pool);
+    free(cycle_members);
+    free(forward);
+    free(backward);
+}
+
+// Rerun Tarjan on the vertices of class k only and split it if it is no longer strongly connected
+static void split_class(t_dynamic_graph *dg, int k) {
+    t_class *cls = &dg->partition.classes[k];
+    int m = cls->size;
+    int *members = malloc(m * sizeof(int));
+    int *tarjan_stack = malloc(m * sizeof(int));
+    int *call_stack = malloc(m * sizeof(int));
+    cell **iterators = malloc(m * sizeof(cell *));
+    int *components = malloc(m * sizeof(int));       // vertices grouped by component
+    int *component_start = malloc((m + 1) * sizeof(int));
+    if (members == NULL || tarjan_stack == NULL || call_stack == NULL || iterators == NULL ||
+        components == NULL || component_start == NULL) {
+        dynamic_alloc_error();
+    }
+    for (int i = 0; i < m; i++) members[i] = cls->vertices[i].identifier;
+    // local_index: -1 = not visited, >= 0 = on the Tarjan stack, -2 = already in a component
+    int counter = 0;
+    int top = 0;
+    int nb_components = 0;
+    int nb_done = 0;
+    for (int r = 0; r < m; r++) {
+        int root = members[r];
+        if (dg->local_index[root] != -1) continue;
+        int depth = 0;
+        dg->local_index[root] = dg->low[root] = counter++;
+        tarjan_stack[top++] = root;
+        call_stack[depth] = root;
+        iterators[depth] = dg->graph->array[root].head;
+        depth++;
+        while (depth > 0) {
+            int v = call_stack[depth - 1];
+            cell *c = iterators[depth - 1];
+            if (c != NULL) {
+                iterators[depth - 1] = c->next;
+                int w = c->arr - 1;
+                if (dg->vertex_to_class[w] != k) continue;  // edge leaving the class
+                if (dg->local_index[w] == -1) {
+                    dg->local_index[w] = dg->low[w] = counter++;
+                    tarjan_stack[top++] = w;
+                    call_stack[depth] = w;
+                    iterators[depth] = dg->graph->array[w].head;
+                    depth++;
+                } else if (dg->local_index[w] >= 0 && dg->local_index[w] < dg->low[v]) {
+                    dg->low[v] = dg->local_index[w];
+                }
+                continue;
+            }
+            depth--;
+            if (dg->low[v] == dg->local_index[v]) {
+                component_start[nb_components++] = nb_done;
+                int w;
+                do {
+                    w = tarjan_stack[--top];
+                    dg->local_index[w] = -2;
+                    components[nb_done++] = w;
+                } while (w != v);
+            }
+            if (depth > 0) {
+                int parent = call_stack[depth - 1];
+                if (dg->low[v] < dg->low[parent]) dg->low[parent] = dg->low[v];
+            }
+        }
+    }
+    component_start[nb_components] = nb_done;
+    for (int i = 0; i < m; i++) dg->local_index[members[i]] = -1;
+    if (nb_components > 1) {
+        // detach the old class from its neighbours, the links are recounted below
+        for (int i = 0; i < dg->out_links[k].size; i++) {
+            adj_sub(&dg->in_links[dg->out_links[k].targets[i]], k, -1);
+        }
+        for (int i = 0; i < dg->in_links[k].size; i++) {
+            adj_sub(&dg->out_links[dg->in_links[k].targets[i]], k, -1);
+        }
+        dg->out_links[k].size = 0;
+        dg->in_links[k].size = 0;
+        // Tarjan emits sinks first: the last component takes the old position, the others follow
+        int base = dg->position[k];
+        for (int c = 0; c < dg->partition.size; c++) {
+            if (dg->position[c] > base) dg->position[c] += nb_components - 1;
+        }
+        int first_new = dg->partition.size;
+        t_tarjan_vertex *old_vertices = dg->partition.classes[k].vertices;
+        dg->partition.classes[k].vertices = NULL;
+        dg->partition.classes[k].size = 0;
+        dg->partition.classes[k].capacity = 0;
+        for (int comp = 0; comp < nb_components; comp++) {
+            int slot = (comp == 0) ? k : new_class_slot(dg);
+            dg->position[slot] = base + nb_components - 1 - comp;
+            for (int i = component_start[comp]; i < component_start[comp + 1]; i++) {
+                dg->vertex_to_class[components[i]] = slot;
+            }
+        }
+        for (int i = 0; i < m; i++) {
+            int v = old_vertices[i].identifier;
+            class_append(&dg->partition.classes[dg->vertex_to_class[v]], old_vertices[i]);
+        }
+        free(old_vertices);
+        // recount the links of the pieces
+        for (int i = 0; i < m; i++) {
+            int v = members[i];
+            int cv = dg->vertex_to_class[v];
+            for (cell *c = dg->graph->array[v].head; c != NULL; c = c->next) {
+                int cw = dg->vertex_to_class[c->arr - 1];
+                if (cw != cv) link_add(dg, cv, cw, 1);
+            }
+            for (cell *c = dg->reverse.array[v].head; c != NULL; c = c->next) {
+                int cp = dg->vertex_to_class[c->arr - 1];
+                if (cp != k && cp < first_new) link_add(dg, cp, cv, 1);  // edge from outside the old class
+            }
+        }
+        for (int c = 0; c < dg->partition.size; c++) dg->order[dg->position[c]] = c;
+    }
+    free(members);
+    free(tarjan_stack);
+    free(call_stack);
+    free(iterators);
+    free(components);
+    free(component_start);
+}
+
+// Function that builds the dynamic structures from a loaded graph (one full Tarjan pass)
+t_dynamic_graph* create_dynamic_graph(a_list *graph) {
+    if (graph == NULL || graph->array == NULL) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return NULL;
+    }
+    t_dynamic_graph *dg = calloc(1, sizeof(t_dynamic_graph));
+    if (dg == NULL) {
+        fprintf(stderr, "Memory allocation error for dynamic graph (sorry ;()\n");
+        return NULL;
+    }
+    int n = graph->size;
+    dg->graph = graph;
+    dg->partition = compute_partition(graph);
+    dg->next_name = dg->partition.size + 1;
+    dg->vertex_to_class = create_vertex_to_class(&dg->partition, n);
+    dg->local_index = malloc(n * sizeof(int));
+    dg->low = malloc(n * sizeof(int));
+    if (dg->vertex_to_class == NULL || dg->local_index == NULL || dg->low == NULL) {
+        dynamic_alloc_error();
+    }
+    for (int v = 0; v < n; v++) dg->local_index[v] = -1;
+    ensure_class_capacity(dg, dg->partition.size);
+    // compute_partition emits the classes sinks first, so reversed indices give a topological order
+    for (int c = 0; c < dg->partition.size; c++) {
+        dg->position[c] = dg->partition.size - 1 - c;
+        dg->order[dg->partition.size - 1 - c] = c;
+    }
+    // reverse adjacency and counted class links
+    a_list *reverse = create_a_list(n);
+    dg->reverse = *reverse;
+    free(reverse);
+    for (int v = 0; v < n; v++) {
+        int cv = dg->vertex_to_class[v];
+        for (cell *c = graph->array[v].head; c != NULL; c = c->next) {
+            int w = c->arr - 1;
+            insert_cell(&dg->reverse.array[w], v + 1, c->proba);
+            int cw = dg->vertex_to_class[w];
+            if (cv != cw) link_add(dg, cv, cw, 1);
+        }
+    }
+    return dg;
+}
+
+// Function that frees the dynamic structures (the edited graph itself stays with the caller)
+void free_dynamic_graph(t_dynamic_graph *dg) {
+    if (dg == NULL) return;
+    for (int c = 0; c < dg->partition.size; c++) {
+        free(dg->partition.classes[c].name);
+        free(dg->partition.classes[c].vertices);
+    }
+    for (int c = 0; c < dg->class_capacity; c++) {
+        free(dg->out_links[c].targets);
+        free(dg->out_links[c].counts);
+        free(dg->in_links[c].targets);
+        free(dg->in_links[c].counts);
+    }
+    for (int v = 0; v < dg->reverse.size; v++) free_list(&dg->reverse.array[v]);
+    free(dg->reverse.array);
+    free(dg->partition.classes);
+    free(dg->vertex_to_class);
+    free(dg->out_links);
+    free(dg->in_links);
+    free(dg->position);
+    free(dg->order);
+    free(dg->mark_f);
+    free(dg->mark_b);
+    free(dg->local_index);
+    free(dg->low);
+    free(dg);
+}
+
+// Function that adds the edge from -> to (an existing edge gets the probability added to it)
+int dynamic_add_edge(t_dynamic_graph *dg, int from, int to, float proba) {
+    int n = dg->graph->size;
+    if (from < 1 || from > n || to < 1 || to > n) {
+        fprintf(stderr, "Warning: ignoring out-of-range edge %d -> %d\n", from, to);
+        return 0;
+    }
+    insert_cell(&dg->reverse.array[to - 1], from, proba);
+    if (!insert_cell(&dg->graph->array[from - 1], to, proba)) {
+        return 1;  // existing edge, only its probability changed
+    }
+    int x = dg->vertex_to_class[from - 1];
+    int y = dg->vertex_to_class[to - 1];
+    if (x == y) return 1;
+    if (adj_find(&dg->out_links[x], y) >= 0 || dg->position[x] < dg->position[y]) {
+        link_add(dg, x, y, 1);  // already in topological order
+    } else {
+        insert_backward_link(dg, x, y);
+    }
+    return 1;
+}
+
+// Function that removes the edge from -> to
+int dynamic_remove_edge(t_dynamic_graph *dg, int from, int to) {
+    int n = dg->graph->size;
+    if (from < 1 || from > n || to < 1 || to > n || !remove_cell(&dg->graph->array[from - 1], to)) {
+        fprintf(stderr, "Warning: no edge %d -> %d to remove\n", from, to);
+        return 0;
+    }
+    remove_cell(&dg->reverse.array[to - 1], from);
+    int x = dg->vertex_to_class[from - 1];
+    int y = dg->vertex_to_class[to - 1];
+    if (x != y) {
+        link_sub(dg, x, y, 1);  // removing a link never breaks the topological order
+    } else {
+        split_class(dg, x);
+    }
+    return 1;
+}
+
+// Function that changes the probability of the edge from -> to (the structure is unchanged)
+int dynamic_reweight_edge(t_dynamic_graph *dg, int from, int to, float proba) {
+    int n = dg->graph->size;
+    cell *c = NULL;
+    if (from >= 1 && from <= n && to >= 1 && to <= n) {
+        c = find_cell(&dg->graph->array[from - 1], to);
+    }
+    if (c == NULL) {
+        fprintf(stderr, "Warning: no edge %d -> %d to reweight\n", from, to);
+        return 0;
+    }
+    c->proba = proba;
+    find_cell(&dg->reverse.array[to - 1], from)->proba = proba;
+    return 1;
+}
+
+// Function that tells whether a class is transient (it has a link towards another class)
+int dynamic_is_transient(const t_dynamic_graph *dg, int class_index) {
+    return dg->out_links[class_index].size > 0;
+}
+
+// Function that builds the class links matrix in the format returned by Hasse
+int** dynamic_class_links(const t_dynamic_graph *dg) {
+    int num_classes = dg->partition.size;
+    int **class_links = malloc(num_classes * sizeof(int *));
+    if (class_links == NULL) dynamic_alloc_error();
+    for (int i = 0; i < num_classes; i++) {
+        class_links[i] = calloc(num_classes, sizeof(int));
+        if (class_links[i] == NULL) dynamic_alloc_error();
+        for (int j = 0; j < dg->out_links[i].size; j++) {
+            class_links[i][dg->out_links[i].targets[j]] = 1;
+        }
+    }
+    return class_links;
+}
+
+// Function that displays the current classes (in topological order) with their links and flags
+void display_dynamic_graph(const t_dynamic_graph *dg) {
+    for (int p = 0; p < dg->partition.size; p++) {
+        int c = dg->order[p];
+        t_class *cls = &dg->partition.classes[c];
+        printf("Class %s {", cls->name);
+        for (int j = 0; j < cls->size; j++) {
+            printf("%d", cls->vertices[j].identifier + 1);
+            if (j < cls->size - 1) printf(",");
+        }
+        if (dynamic_is_transient(dg, c)) {
+            printf("} transient ->");
+            for (int j = 0; j < dg->out_links[c].size; j++) {
+                printf(" %s", dg->partition.classes[dg->out_links[c].targets[j]].name);
+            }
+            printf("\n");
+        } else {
+            printf("} persistent%s\n", (cls->size == 1) ? " (absorbing)" : "");
+        }
+    }
+}
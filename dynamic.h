@@ -0,0 +1,53 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef DYNAMIC_H
+#define DYNAMIC_H
+#include "functions.h"
+
+// Links leaving (or entering) one class, with the number of graph edges behind each link
+typedef struct {
+    int *targets;   // Indices of the linked classes
+    int *counts;    // Number of graph edges realising each link
+    int size;       // Current number of links
+    int capacity;   // Maximum capacity
+} t_class_adj;
+
+// Graph whose partition is kept up to date while edges are added or removed
+typedef struct {
+    a_list *graph;              // Graph being edited (not owned)
+    a_list reverse;             // Predecessors of each vertex (1-based, like graph cells)
+    t_partition partition;      // Current strongly connected components
+    int *vertex_to_class;       // Class index of each vertex (0-based)
+    t_class_adj *out_links;     // Class links leaving each class
+    t_class_adj *in_links;      // Class links entering each class
+    int *position;              // Topological position of each class (links go to higher positions)
+    int *order;                 // Class stored at each topological position
+    int class_capacity;         // Allocated length of the per-class arrays
+    int next_name;              // Number used for the next class name
+    int *mark_f;                // Scratch marks for forward searches over classes
+    int *mark_b;                // Scratch marks for backward searches over classes
+    int stamp;                  // Current mark value (avoids clearing the mark arrays)
+    int *local_index;           // Scratch Tarjan numbering used when a class is split
+    int *low;                   // Scratch Tarjan accessible numbers used when a class is split
+} t_dynamic_graph;
+
+t_dynamic_graph* create_dynamic_graph(a_list *);
+
+void free_dynamic_graph(t_dynamic_graph *);
+
+// Edge operations use the 1-based vertex numbers of the input file
+int dynamic_add_edge(t_dynamic_graph *, int, int, float);
+
+int dynamic_remove_edge(t_dynamic_graph *, int, int);
+
+int dynamic_reweight_edge(t_dynamic_graph *, int, int, float);
+
+int dynamic_is_transient(const t_dynamic_graph *, int);
+
+int** dynamic_class_links(const t_dynamic_graph *);
+
+void display_dynamic_graph(const t_dynamic_graph *);
+
+#endif //DYNAMIC_H
@@ -3,8 +3,10 @@
 //
 
 #include "functions.h"
-#include "utils.c"
+#include "utils.h"
 #include "hasse.h"
+#include "small_matrix.h"
+#include <stdint.h>
 
 
 // Create a new cell for a linked list
@@ -27,15 +29,149 @@ cell *create_cell(int arr, float proba) {
 list create_list() {
     list l;
     l.head = NULL; // initialize with no elements
+    l.size = 0;
+    l.capacity = 0;
     return l;
 }
 
 
-// Add a new cell to the beginning of a linked list
+static void block_insert(list *l, int arr, float proba);
+
+// Add a cell to a list: at the beginning of a linked list, at its sorted place in a block list
 void add_cell(list *l, int arr, float proba) {
+    if (l->capacity > 0) {
+        block_insert(l, arr, proba);          // sorted block: the cell goes at its place
+        return;
+    }
     cell *new_cell = create_cell(arr, proba); // create the new cell
     new_cell->next = l->head;                 // link to current head
     l->head = new_cell;                       // update list head
+    l->size++;
+}
+
+
+// qsort comparator of cells by target, for sorting the cells of a block
+int compare_cells(const void *a, const void *b) {
+    int x = ((const cell *)a)->arr;
+    int y = ((const cell *)b)->arr;
+    return (x > y) - (x < y);
+}
+
+// Restore the next pointers of a block list from cell first on (after these cells moved)
+void relink_block(list *l, int first) {
+    for (int i = first; i < l->size; i++) {
+        l->head[i].next = (i + 1 < l->size) ? &l->head[i + 1] : NULL;
+    }
+}
+
+// Binary search of a target in a block list: index of the cell, or where it should be inserted
+static int block_search(const list *l, int arr) {
+    int low = 0;
+    int high = l->size;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (l->head[mid].arr < arr) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+// Find the cell going to arr in a list (NULL if there is none)
+cell *find_cell(const list *l, int arr) {
+    if (l->capacity > 0) {
+        // sorted block: binary search
+        int i = block_search(l, arr);
+        return (i < l->size && l->head[i].arr == arr) ? &l->head[i] : NULL;
+    }
+    cell *current = l->head;
+    while (current != NULL && current->arr != arr) current = current->next;
+    return current;
+}
+
+// Insert an edge keeping the list sorted, or add the probability to the existing edge
+// Returns 1 if a new cell was created, 0 if the edge already existed
+int insert_cell(list *l, int arr, float proba) {
+    cell *existing = find_cell(l, arr);
+    if (existing != NULL) {
+        existing->proba += proba;
+        return 0;
+    }
+    if (l->head != NULL && l->capacity == 0) {
+        add_cell(l, arr, proba);  // list built cell by cell, keep it that way
+    } else {
+        block_insert(l, arr, proba);
+    }
+    return 1;
+}
+
+// Insert a cell at its sorted place in a block list (or in an empty list, which becomes a block)
+static void block_insert(list *l, int arr, float proba) {
+    int moved = 0;
+    if (l->size >= l->capacity) {
+        int capacity = (l->capacity == 0) ? 2 : l->capacity * 2;
+        uintptr_t old_address = (uintptr_t)l->head;  // the old pointer cannot be compared once freed
+        cell *block = realloc(l->head, capacity * sizeof(cell));
+        if (block == NULL) {
+            fprintf(stderr, "Memory allocation error (Never sure how that happens honestly. Unfreed memory? Problem with the engine? Take your guess :p)\n");
+            exit(EXIT_FAILURE);
+        }
+        moved = ((uintptr_t)block != old_address);
+        l->head = block;
+        l->capacity = capacity;
+    }
+    int i = block_search(l, arr);
+    memmove(&l->head[i + 1], &l->head[i], (l->size - i) * sizeof(cell));
+    l->head[i].arr = arr;
+    l->head[i].proba = proba;
+    l->size++;
+    // the cells before i did not move, only cell i - 1 may have been the last one
+    relink_block(l, (moved || i == 0) ? 0 : i - 1);
+}
+
+// Remove the edge going to arr from a list. Returns 1 if it was found
+int remove_cell(list *l, int arr) {
+    if (l->capacity > 0) {
+        int i = block_search(l, arr);
+        if (i >= l->size || l->head[i].arr != arr) return 0;
+        memmove(&l->head[i], &l->head[i + 1], (l->size - i - 1) * sizeof(cell));
+        l->size--;
+        relink_block(l, (i > 0) ? i - 1 : 0);  // cell i - 1 may now be the last one
+        if (l->size == 0) free_list(l);  // an empty list must have a NULL head
+        return 1;
+    }
+    cell *previous = NULL;
+    cell *current = l->head;
+    while (current != NULL && current->arr != arr) {
+        previous = current;
+        current = current->next;
+    }
+    if (current == NULL) return 0;
+    if (previous == NULL) {
+        l->head = current->next;
+    } else {
+        previous->next = current->next;
+    }
+    free(current);
+    l->size--;
+    return 1;
+}
+
+// Free the cells of a list
+void free_list(list *l) {
+    if (l->capacity > 0) {
+        free(l->head);  // one block
+    } else {
+        cell *current = l->head;
+        while (current != NULL) {
+            cell *next = current->next;
+            free(current);
+            current = next;
+        }
+    }
+    *l = create_list();
 }
 
 
@@ -84,11 +220,20 @@ void display_a_list(const a_list *graph) {
 
 // Read a graph from a text file into adjacency list form
 a_list readGraph(const char *filename) {
+    t_read_options options = {0};
+    return readGraphWithOptions(filename, &options);
+}
+
+// Read a graph from a text file. Each vertex gets its edges in one block sorted by target,
+// and parallel edges (same start and end) are merged by summing their probabilities.
+// In rate mode the values are the off-diagonal entries of a generator: the diagonal is implied by
+// the other rates of the row, so the lines i i q are skipped and the rows do not have to sum to 1
+a_list readGraphWithOptions(const char *filename, const t_read_options *options) {
     FILE *file = fopen(filename, "r");
     int nbvert, start, end;
     float proba;
     // declare the variable for the adjacency list
-    a_list *list;
+    a_list *graph;
     if (file == NULL) {
         perror("Could not open file for reading (kindly reminder not to try this function with an empty file /:)");
         exit(EXIT_FAILURE);
@@ -98,7 +243,16 @@ a_list readGraph(const char *filename) {
         perror("Could not read number of vertices (Typo, typo, go away, verifying your file goes a long way)");
         exit(EXIT_FAILURE);
     }
-    list = create_a_list(nbvert); // Initialise an empty adjacency list using the number of vertices
+    graph = create_a_list(nbvert); // Initialise an empty adjacency list using the number of vertices
+    // first pass: keep the edges in the order of the file
+    int nb_edges = 0;
+    int edges_capacity = 64;
+    int *starts = malloc(edges_capacity * sizeof(int));
+    cell *edges = malloc(edges_capacity * sizeof(cell));
+    if (starts == NULL || edges == NULL) {
+        fprintf(stderr, "Memory allocation error (Never sure how that happens honestly. Unfreed memory? Problem with the engine? Take your guess :p)\n");
+        exit(EXIT_FAILURE);
+    }
     while (fscanf(file, "%d %d %f", &start, &end, &proba) == 3) {
         // check vertex range
         // we obtain, for each line of the file, the values
@@ -107,13 +261,68 @@ a_list readGraph(const char *filename) {
             fprintf(stderr, "Warning: ignoring out-of-range edge %d -> %d\n", start, end);
             continue;
         }
-        int s = start - 1; // convert to 0-based
-        cell *new_cell = create_cell(end, proba);
-        new_cell->next = list->array[s].head; // insert at head
-        list->array[s].head = new_cell;
+        if (options != NULL && options->rates && start == end) continue;
+        if (nb_edges >= edges_capacity) {
+            edges_capacity *= 2;
+            starts = realloc(starts, edges_capacity * sizeof(int));
+            edges = realloc(edges, edges_capacity * sizeof(cell));
+            if (starts == NULL || edges == NULL) {
+                fprintf(stderr, "Memory allocation error (Never sure how that happens honestly. Unfreed memory? Problem with the engine? Take your guess :p)\n");
+                exit(EXIT_FAILURE);
+            }
+        }
+        starts[nb_edges] = start - 1; // convert to 0-based
+        edges[nb_edges].arr = end;
+        edges[nb_edges].proba = proba;
+        nb_edges++;
     }
     fclose(file);
-    return *list;
+    // second pass: one block per vertex, sized with the number of edges leaving it
+    for (int e = 0; e < nb_edges; e++) graph->array[starts[e]].capacity++;
+    for (int v = 0; v < nbvert; v++) {
+        if (graph->array[v].capacity == 0) continue;
+        graph->array[v].head = malloc(graph->array[v].capacity * sizeof(cell));
+        if (graph->array[v].head == NULL) {
+            fprintf(stderr, "Memory allocation error (Never sure how that happens honestly. Unfreed memory? Problem with the engine? Take your guess :p)\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (int e = 0; e < nb_edges; e++) {
+        list *l = &graph->array[starts[e]];
+        l->head[l->size++] = edges[e];
+    }
+    free(starts);
+    free(edges);
+    // sort each block by target and merge the parallel edges
+    for (int v = 0; v < nbvert; v++) {
+        list *l = &graph->array[v];
+        if (l->size == 0) continue;
+        qsort(l->head, l->size, sizeof(cell), compare_cells);
+        int kept = 0;
+        for (int i = 1; i < l->size; i++) {
+            if (l->head[i].arr == l->head[kept].arr) {
+                if (options != NULL && options->warn_duplicates) {
+                    fprintf(stderr, "Warning: merging duplicate edge %d -> %d (%.4f + %.4f)\n",
+                            v + 1, l->head[i].arr, l->head[kept].proba, l->head[i].proba);
+                }
+                l->head[kept].proba += l->head[i].proba;
+            } else {
+                l->head[++kept] = l->head[i];
+            }
+        }
+        l->size = kept + 1;
+        relink_block(l, 0);
+    }
+    a_list result = *graph;
+    free(graph);
+    return result;
+}
+
+// Probability of the edge from -> to (1-based vertices), 0 if there is no such edge
+float get_proba(const a_list *graph, int from, int to) {
+    if (from < 1 || from > graph->size) return 0;
+    cell *c = find_cell(&graph->array[from - 1], to);
+    return (c == NULL) ? 0 : c->proba;
 }
 
 // Check if the graph probabilities are valid (~1 per vertex)
@@ -174,19 +383,19 @@ void export_graph(a_list *graph, const char *filename) {
     fprintf(file, "---\nconfig:\n layout: elk\n theme: neo\n look: neo\n---\nflowchart LR\n");
     // Write vertices
     for (int i = 0; i < graph->size; i++) {
-        char id[10];
-        strcpy(id, getID(i + 1));
+        char id[ID_BUFFER_SIZE];
+        getID(i + 1, id);
         fprintf(file, "%s((%d))\n", id, i + 1);
     }
     fprintf(file, "\n");
     // Write edges
     for (int i = 0; i < graph->size; i++) {
-        char source_id[10];
-        strcpy(source_id, getID(i + 1));
+        char source_id[ID_BUFFER_SIZE];
+        getID(i + 1, source_id);
         cell *curr = graph->array[i].head;
         while (curr != NULL) {
-            char target_id[10];
-            strcpy(target_id, getID(curr->arr));
+            char target_id[ID_BUFFER_SIZE];
+            getID(curr->arr, target_id);
             fprintf(file, "%s -->|%.2f|%s\n", source_id, curr->proba, target_id);
             curr = curr->next;
         }
@@ -291,13 +500,13 @@ void parcours(int top, a_list *graph, t_tarjan_array *tarjan_array,
     if (current->acc_number == current->number) {
         // Create new class for strongly connected component
         t_class new_class;
-        new_class.name = malloc(10 * sizeof(char));
-        sprintf(new_class.name, "C%d", partition->size + 1);
+        new_class.name = malloc(13 * sizeof(char));  // "C" and up to 11 characters for an int
+        snprintf(new_class.name, 13, "C%d", partition->size + 1);
         new_class.vertices = malloc(tarjan_array->size * sizeof(t_tarjan_vertex));
         new_class.size = 0;
         new_class.capacity = tarjan_array->size;
         // Pop vertices until we reach current vertex
-        int w_vertex;
+        int w_vertex = -1;
         while (w_vertex != top) {
             w_vertex = pop(stack);
             t_tarjan_vertex *w = &tarjan_array->vertices[w_vertex];
@@ -351,6 +560,10 @@ void tarjan(a_list *graph) {
         free(partition.classes[i].vertices);
     }
     free(partition.classes);
+    free(tarjan_array->vertices);
+    free(tarjan_array);
+    free(stack->data);
+    free(stack);
 }
 
 
@@ -372,20 +585,34 @@ t_partition compute_partition(a_list *graph) {
             parcours(i, graph, tarjan_array, stack, &num, &partition);
         }
     }
+    free(tarjan_array->vertices);
+    free(tarjan_array);
+    free(stack->data);
+    free(stack);
     return partition;
 }
 
-int** Hasse(a_list *graph, t_partition *partition) {
-    int num_classes = partition->size;
-    // Create vertex-to-class mapping
-    // This array maps each vertex ID to its corresponding class index in the partition
-    int *vertex_to_class = malloc(graph->size * sizeof(int));
+// Function that maps each vertex ID (0-based) to the index of its class in the partition
+int* create_vertex_to_class(t_partition *partition, int nb_vertices) {
+    int *vertex_to_class = malloc(nb_vertices * sizeof(int));
+    if (vertex_to_class == NULL) {
+        fprintf(stderr, "Memory allocation error for vertex to class mapping (sorry ;()\n");
+        return NULL;
+    }
     for (int c = 0; c < partition->size; c++) {
         for (int v = 0; v < partition->classes[c].size; v++) {
             int vertex_id = partition->classes[c].vertices[v].identifier;
             vertex_to_class[vertex_id] = c;  // Store class index for this vertex
         }
     }
+    return vertex_to_class;
+}
+
+int** Hasse(a_list *graph, t_partition *partition) {
+    int num_classes = partition->size;
+    // Create vertex-to-class mapping
+    // This array maps each vertex ID to its corresponding class index in the partition
+    int *vertex_to_class = create_vertex_to_class(partition, graph->size);
     // Create class links matrix (adjacency matrix for classes)
     // This is a num_classes x num_classes matrix where:
     // class_links[i][j] = 1 if there's an edge from class i to class j, 0 otherwise
@@ -467,6 +694,167 @@ void analyze_graph_characteristics(t_partition *partition, int **class_links, in
     free(has_outgoing);
 }
 
+// Function that computes the partition and the nature of every class in a single traversal
+// Tarjan finishes the components sinks first, so when a vertex has an edge to a vertex that is
+// already visited and no longer on the stack, that edge leaves its component: the class is known
+// to be transient or persistent at the moment it is popped, without building the class links.
+// The depth-first search is iterative, so long chains do not overflow the call stack.
+t_classification classify_graph(a_list *graph) {
+    t_classification result = {{NULL, 0, 0}, NULL, 0, 0, 0, 0};
+    if (graph == NULL || graph->array == NULL) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return result;
+    }
+    int n = graph->size;
+    int *number = malloc(n * sizeof(int));
+    int *acc_number = malloc(n * sizeof(int));
+    char *on_stack = calloc(n + 1, 1);
+    char *has_exit = calloc(n + 1, 1);      // vertex with an edge leaving its component
+    int *stack = malloc(n * sizeof(int));
+    int *path = malloc(n * sizeof(int));     // vertices of the depth-first path
+    cell **next_edge = malloc(n * sizeof(cell *));
+    result.partition.classes = malloc((n > 0 ? n : 1) * sizeof(t_class));
+    result.partition.capacity = n;
+    result.flags = malloc((n > 0 ? n : 1) * sizeof(t_class_flags));
+    if ((n > 0 && (number == NULL || acc_number == NULL || stack == NULL || path == NULL || next_edge == NULL)) ||
+        on_stack == NULL || has_exit == NULL || result.partition.classes == NULL || result.flags == NULL) {
+        fprintf(stderr, "Memory allocation error for classification (sorry ;()\n");
+        free(number);
+        free(acc_number);
+        free(on_stack);
+        free(has_exit);
+        free(stack);
+        free(path);
+        free(next_edge);
+        free_classification(&result);
+        return result;
+    }
+    for (int v = 0; v < n; v++) number[v] = -1;
+    int num = 0;
+    int top = -1;
+    for (int root = 0; root < n; root++) {
+        if (number[root] != -1) continue;
+        int depth = 0;
+        path[depth++] = root;
+        number[root] = acc_number[root] = num++;
+        stack[++top] = root;
+        on_stack[root] = 1;
+        next_edge[root] = graph->array[root].head;
+        while (depth > 0) {
+            int v = path[depth - 1];
+            cell *c = next_edge[v];
+            if (c != NULL) {
+                next_edge[v] = c->next;
+                int w = c->arr - 1;
+                if (number[w] == -1) {
+                    // descend; the edge is checked again when w is finished
+                    number[w] = acc_number[w] = num++;
+                    stack[++top] = w;
+                    on_stack[w] = 1;
+                    next_edge[w] = graph->array[w].head;
+                    path[depth++] = w;
+                } else if (on_stack[w]) {
+                    if (number[w] < acc_number[v]) acc_number[v] = number[w];
+                } else {
+                    has_exit[v] = 1;  // w belongs to a component that is already complete
+                }
+                continue;
+            }
+            // all the edges of v are done
+            depth--;
+            if (acc_number[v] == number[v]) {
+                t_class new_class;
+                int size = 0;
+                while (stack[top - size] != v) size++;
+                size++;
+                new_class.name = malloc(13 * sizeof(char));
+                snprintf(new_class.name, 13, "C%d", result.partition.size + 1);
+                new_class.vertices = malloc(size * sizeof(t_tarjan_vertex));
+                new_class.size = 0;
+                new_class.capacity = size;
+                int exits = 0;
+                int w_vertex = -1;
+                while (w_vertex != v) {
+                    w_vertex = stack[top--];
+                    on_stack[w_vertex] = 0;
+                    exits |= has_exit[w_vertex];
+                    t_tarjan_vertex member = {w_vertex, number[w_vertex], acc_number[w_vertex], 0};
+                    new_class.vertices[new_class.size++] = member;
+                }
+                t_class_flags *flags = &result.flags[result.partition.size];
+                flags->size = size;
+                flags->transient = exits;
+                flags->persistent = !exits;
+                flags->absorbing = !exits && size == 1;
+                result.nb_transient += exits;
+                result.nb_persistent += !exits;
+                result.nb_absorbing += flags->absorbing;
+                result.partition.classes[result.partition.size++] = new_class;
+            }
+            if (depth > 0) {
+                // back in the parent u: the edge u -> v leaves u's component if v's is complete
+                int u = path[depth - 1];
+                if (on_stack[v]) {
+                    if (acc_number[v] < acc_number[u]) acc_number[u] = acc_number[v];
+                } else {
+                    has_exit[u] = 1;
+                }
+            }
+        }
+    }
+    result.irreducible = (result.partition.size == 1);
+    free(number);
+    free(acc_number);
+    free(on_stack);
+    free(has_exit);
+    free(stack);
+    free(path);
+    free(next_edge);
+    return result;
+}
+
+// Function that displays the classification in the format of analyze_graph_characteristics
+void display_classification(const t_classification *classification) {
+    const t_partition *partition = &classification->partition;
+    printf("\nGraph Characteristics:\n");
+    for (int i = 0; i < partition->size; i++) {
+        const char *nature = classification->flags[i].transient ? "transient" : "persistent";
+        printf("Class %s is %s - states {", partition->classes[i].name, nature);
+        for (int j = 0; j < partition->classes[i].size; j++) {
+            printf("%d", partition->classes[i].vertices[j].identifier + 1);
+            if (j < partition->classes[i].size - 1) printf(",");
+        }
+        printf("} are %s\n", nature);
+        if (classification->flags[i].absorbing) {
+            printf("  State %d is ABSORBING\n", partition->classes[i].vertices[0].identifier + 1);
+        }
+    }
+    printf("\nGlobal characteristics:\n");
+    if (classification->irreducible) {
+        printf("- The Markov graph is IRREDUCIBLE (only one class)\n");
+    } else {
+        printf("- The Markov graph is NOT IRREDUCIBLE (%d classes)\n", partition->size);
+    }
+    if (classification->nb_absorbing > 0) {
+        printf("- There are %d absorbing state(s)\n", classification->nb_absorbing);
+    } else {
+        printf("- There are NO absorbing states\n");
+    }
+}
+
+// Function that frees a classification
+void free_classification(t_classification *classification) {
+    for (int i = 0; i < classification->partition.size; i++) {
+        free(classification->partition.classes[i].name);
+        free(classification->partition.classes[i].vertices);
+    }
+    free(classification->partition.classes);
+    free(classification->flags);
+    classification->partition.classes = NULL;
+    classification->partition.size = 0;
+    classification->flags = NULL;
+}
+
 // Function that creates an n x n matrix from adjacency list with transition probabilities
 matrix* create_transition_matrix(a_list *graph) {
     if (graph == NULL || graph->array == NULL) {
@@ -582,6 +970,15 @@ matrix* multiply_matrices(matrix *a, matrix *b) {
     if (result == NULL) {
         return NULL;
     }
+    // Small chains go through the specialised kernels (same result, no loop overhead)
+    if (size <= SMALL_MATRIX_MAX) {
+        t_small_matrix small_a, small_b, small_result;
+        small_matrix_load(&small_a, a);
+        small_matrix_load(&small_b, b);
+        small_matrix_multiply(&small_a, &small_b, &small_result);
+        small_matrix_store(&small_result, result);
+        return result;
+    }
     // Perform matrix multiplication
     for (int i = 0; i < size; i++) {  // Iterate through rows of first matrix
         for (int j = 0; j < size; j++) {  // Iterate through columns of second matrix
@@ -673,3 +1070,101 @@ matrix* subMatrix(matrix *original_mat, t_partition *part, int compo_index) {
     }
     return submat;  // Return extracted submatrix
 }
+
+// Function that frees a matrix
+void free_matrix(matrix *m) {
+    if (m == NULL) return;
+    if (m->data != NULL) {
+        for (int i = 0; i < m->size; i++) free(m->data[i]);
+    }
+    free(m->data);
+    free(m);
+}
+
+// Function that gives a view of the block of a component without copying it
+// The view stays valid as long as the matrix and the partition are not freed
+t_submatrix_view subMatrix_view(matrix *original_mat, t_partition *part, int compo_index) {
+    t_submatrix_view view = {NULL, NULL, 0};
+    if (compo_index < 0 || compo_index >= part->size) {
+        fprintf(stderr, "Error: Invalid component index %d (valid range: 0 to %d)\n",
+                compo_index, part->size - 1);
+        return view;
+    }
+    if (original_mat == NULL || original_mat->data == NULL) {  // Validate input matrix
+        fprintf(stderr, "Error: Invalid input matrix\n");
+        return view;
+    }
+    view.parent = original_mat;
+    view.members = part->classes[compo_index].vertices;
+    view.size = part->classes[compo_index].size;
+    return view;
+}
+
+// Function that copies the blocks of all the components in one pass over the rows of the matrix
+// Each row is only read at the columns of its own class, rows are processed in parallel
+t_class_blocks* extract_class_blocks(matrix *original_mat, t_partition *part) {
+    if (original_mat == NULL || original_mat->data == NULL || part == NULL) {
+        fprintf(stderr, "Error: Invalid input matrix\n");
+        return NULL;
+    }
+    int n = original_mat->size;
+    t_class_blocks *blocks = malloc(sizeof(t_class_blocks));
+    int *vertex_to_class = create_vertex_to_class(part, n);
+    int *local = malloc(n * sizeof(int));  // index of each vertex inside its class
+    if (blocks == NULL || vertex_to_class == NULL || local == NULL) {
+        fprintf(stderr, "Memory allocation error for class blocks (sorry ;()\n");
+        free(blocks);
+        free(vertex_to_class);
+        free(local);
+        return NULL;
+    }
+    blocks->nb_blocks = part->size;
+    blocks->offsets = malloc((part->size + 1) * sizeof(size_t));
+    blocks->sizes = malloc(part->size * sizeof(int));
+    blocks->data = NULL;
+    if (blocks->offsets == NULL || (part->size > 0 && blocks->sizes == NULL)) {
+        fprintf(stderr, "Memory allocation error for class blocks (sorry ;()\n");
+        free(vertex_to_class);
+        free(local);
+        free_class_blocks(blocks);
+        return NULL;
+    }
+    blocks->offsets[0] = 0;
+    for (int c = 0; c < part->size; c++) {
+        int m = part->classes[c].size;
+        blocks->sizes[c] = m;
+        blocks->offsets[c + 1] = blocks->offsets[c] + (size_t)m * m;
+        for (int i = 0; i < m; i++) local[part->classes[c].vertices[i].identifier] = i;
+    }
+    blocks->data = malloc((blocks->offsets[part->size] > 0 ? blocks->offsets[part->size] : 1) * sizeof(float));
+    if (blocks->data == NULL) {
+        fprintf(stderr, "Memory allocation error for class blocks (sorry ;()\n");
+        free(vertex_to_class);
+        free(local);
+        free_class_blocks(blocks);
+        return NULL;
+    }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+    for (int i = 0; i < n; i++) {
+        int c = vertex_to_class[i];
+        const t_tarjan_vertex *members = part->classes[c].vertices;
+        int m = blocks->sizes[c];
+        float *row = &blocks->data[blocks->offsets[c] + (size_t)local[i] * m];
+        const float *source = original_mat->data[i];
+        for (int j = 0; j < m; j++) row[j] = source[members[j].identifier];
+    }
+    free(vertex_to_class);
+    free(local);
+    return blocks;
+}
+
+// Function that frees the blocks extracted by extract_class_blocks
+void free_class_blocks(t_class_blocks *blocks) {
+    if (blocks == NULL) return;
+    free(blocks->data);
+    free(blocks->offsets);
+    free(blocks->sizes);
+    free(blocks);
+}
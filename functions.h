@@ -18,6 +18,8 @@ typedef struct cell {
 //Defines the type list
 typedef struct {
     cell *head;
+    int size;       // Number of cells in the list
+    int capacity;   // Cells allocated in one block at head, sorted by arr (0 when cells are allocated one by one)
 } list;
 
 //Defines the type a_list that we'll mainly use in the project
@@ -61,12 +63,51 @@ typedef struct {
     int capacity;               // Maximum capacity
 } t_stack;
 
+// Structural flags of one class, found while Tarjan pops it
+typedef struct {
+    int size;           // Number of vertices of the class
+    int transient;      // 1 if at least one edge leaves the class
+    int persistent;     // 1 if no edge leaves the class
+    int absorbing;      // 1 if the class is persistent and has a single vertex
+} t_class_flags;
+
+// Partition of the graph together with the flags of every class
+typedef struct {
+    t_partition partition;      // Same classes, in the same order, as compute_partition
+    t_class_flags *flags;       // Flags of each class of the partition
+    int nb_transient;           // Number of transient classes
+    int nb_persistent;          // Number of persistent classes
+    int nb_absorbing;           // Number of absorbing states
+    int irreducible;            // 1 if the graph has a single class
+} t_classification;
+
+// Options for readGraphWithOptions
+typedef struct {
+    int warn_duplicates;        // Print a warning for each merged parallel edge
+    int rates;                  // The file holds the rates of a continuous-time chain, not probabilities
+} t_read_options;
+
 // Matrix structure definition
 typedef struct {
     float **data;   // 2D array for matrix data
     int size;       // Matrix size (n x n)
 } matrix;
 
+// View of the block of one class inside its parent matrix (nothing is copied)
+typedef struct {
+    matrix *parent;                     // Matrix the view reads from
+    const t_tarjan_vertex *members;     // Vertices of the class: row/column i of the view is members[i]
+    int size;                           // Number of vertices of the class
+} t_submatrix_view;
+
+// Blocks of all the classes, copied into one contiguous buffer
+typedef struct {
+    float *data;        // Blocks one after the other, each one row-major
+    size_t *offsets;    // Start of each block in data (nb_blocks + 1 entries)
+    int *sizes;         // Size of each block
+    int nb_blocks;      // Number of blocks (one per class)
+} t_class_blocks;
+
 
 cell *create_cell(int, float);
 
@@ -74,6 +115,18 @@ list create_list();
 
 void add_cell(list *, int, float);
 
+int insert_cell(list *, int, float);
+
+int remove_cell(list *, int);
+
+cell *find_cell(const list *, int);
+
+int compare_cells(const void *, const void *);
+
+void relink_block(list *, int);
+
+void free_list(list *);
+
 void display_list(const list *l);
 
 a_list *create_a_list(int);
@@ -82,6 +135,10 @@ void display_a_list(const a_list *);
 
 a_list readGraph(const char *);
 
+a_list readGraphWithOptions(const char *, const t_read_options *);
+
+float get_proba(const a_list *, int, int);
+
 int check_graph(const char *);
 
 void export_graph(a_list *, const char *);
@@ -102,10 +159,18 @@ void tarjan(a_list *);
 
 t_partition compute_partition(a_list *);
 
+int* create_vertex_to_class(t_partition *, int);
+
 int** Hasse(a_list *, t_partition *);
 
 void analyze_graph_characteristics(t_partition *, int **, int);
 
+t_classification classify_graph(a_list *);
+
+void display_classification(const t_classification *);
+
+void free_classification(t_classification *);
+
 matrix* create_transition_matrix(a_list *);
 
 matrix* create_zero_matrix(int);
@@ -117,4 +182,22 @@ matrix* multiply_matrices(matrix *, matrix *);
 float matrix_difference(matrix *, matrix *);
 
 matrix* subMatrix(matrix *, t_partition *, int);
+
+void free_matrix(matrix *);
+
+t_submatrix_view subMatrix_view(matrix *, t_partition *, int);
+
+// Element (i, j) of a view, read from the parent matrix
+static inline float view_get(const t_submatrix_view *view, int i, int j) {
+    return view->parent->data[view->members[i].identifier][view->members[j].identifier];
+}
+
+t_class_blocks* extract_class_blocks(matrix *, t_partition *);
+
+// Element (i, j) of the block of class c
+static inline float class_blocks_get(const t_class_blocks *blocks, int c, int i, int j) {
+    return blocks->data[blocks->offsets[c] + (size_t)i * blocks->sizes[c] + j];
+}
+
+void free_class_blocks(t_class_blocks *);
 #endif //FUNCTIONS_H
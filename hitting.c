@@ -0,0 +1,233 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "hitting.h"
+
+// Hitting probabilities h and expected hitting times k of a target set T, on the sparse graph:
+//   h(i) = 1 on T, h(i) = sum_j p(i,j) h(j) elsewhere
+//   k(i) = 0 on T, k(i) = 1 + sum_j p(i,j) k(j) elsewhere
+// Vertices that cannot reach T (backward search from T) get h = 0 without solving, and vertices
+// that can reach one of them without going through T have an infinite k.
+// Where T is reached almost surely, h = 1 is also known without solving.
+// compute_partition lists the classes sinks first, so when the classes are solved in that order
+// every value outside the current class is already final: Gauss-Seidel/SOR only iterates inside
+// one class at a time, and transient classes of a single vertex are solved in one sweep.
+// Inside a class the vertices are swept by increasing distance to T, so that the values spread
+// out from T in as few sweeps as possible.
+
+
+static void hitting_alloc_error(void) {
+    fprintf(stderr, "Memory allocation error for hitting analysis (sorry ;()\n");
+}
+
+// Mark every vertex reachable backwards from the seeds, never expanding through a blocked vertex
+// The queue is left holding the marked vertices in breadth-first order, their number is returned
+static int backward_search(const int *pred_offsets, const int *preds, int n, char *marked,
+                            const char *blocked, int *queue) {
+    int head = 0;
+    int tail = 0;
+    for (int v = 0; v < n; v++) {
+        if (marked[v]) queue[tail++] = v;
+    }
+    while (head < tail) {
+        int v = queue[head++];
+        for (int p = pred_offsets[v]; p < pred_offsets[v + 1]; p++) {
+            int u = preds[p];
+            if (marked[u] || (blocked != NULL && blocked[u])) continue;
+            marked[u] = 1;
+            queue[tail++] = u;
+        }
+    }
+    return tail;
+}
+
+// Gauss-Seidel/SOR sweeps over the unknown vertices of one class until they stop moving
+// x(i) = (constant + sum_{j != i} p(i,j) x(j)) / (1 - p(i,i))
+static int solve_class(a_list *graph, const int *vertices, int count, const char *unknown, double constant,
+                       const t_hitting_options *options, double *x, double *residual) {
+    int nb_unknown = 0;
+    for (int k = 0; k < count; k++) nb_unknown += unknown[vertices[k]];
+    if (nb_unknown == 0) return 0;
+    // a single unknown vertex only depends on final values: one plain sweep is exact
+    double omega = (nb_unknown == 1) ? 1.0 : options->omega;
+    int sweeps = 0;
+    int since_best = 0;
+    double best = -1;
+    double delta;
+    do {
+        delta = 0;
+        for (int k = 0; k < count; k++) {
+            int v = vertices[k];
+            if (!unknown[v]) continue;
+            double sum = constant;
+            double diagonal = 0;
+            for (cell *e = graph->array[v].head; e != NULL; e = e->next) {
+                if (e->arr - 1 == v) {
+                    diagonal += e->proba;
+                } else {
+                    sum += e->proba * x[e->arr - 1];
+                }
+            }
+            double value = (diagonal < 1) ? sum / (1 - diagonal) : x[v];
+            value = x[v] + omega * (value - x[v]);
+            double change = value - x[v];
+            if (change < 0) change = -change;
+            if (change > delta) delta = change;
+            x[v] = value;
+        }
+        sweeps++;
+        // over-relaxation is not guaranteed to converge on these systems: when the changes have
+        // not gone down for 50 sweeps, fall back to Gauss-Seidel, which always does
+        if (best < 0 || delta < best) {
+            best = delta;
+            since_best = 0;
+        } else if (++since_best >= 50 && omega != 1.0) {
+            omega = 1.0;
+            best = -1;
+        }
+    } while (nb_unknown > 1 && delta > options->tolerance && sweeps < options->max_iterations);
+    if (nb_unknown > 1 && delta > *residual) *residual = delta;
+    return sweeps;
+}
+
+// Function that computes, for every vertex, the probability of reaching the target vertices
+// (1-based, nb_targets of them) and the expected number of steps to get there
+// options may be NULL (Gauss-Seidel, tolerance 1e-10, at most 100000 sweeps per class)
+t_hitting_result* hitting_analysis(a_list *graph, t_partition *partition, const int *targets, int nb_targets,
+                                   const t_hitting_options *options) {
+    t_hitting_options defaults = {1.0, 1e-10, 100000};
+    if (options == NULL) options = &defaults;
+    if (graph == NULL || graph->array == NULL || partition == NULL || (nb_targets > 0 && targets == NULL)) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return NULL;
+    }
+    int n = graph->size;
+    for (int t = 0; t < nb_targets; t++) {
+        if (targets[t] < 1 || targets[t] > n) {
+            fprintf(stderr, "Error: Invalid target vertex %d (valid range: 1 to %d)\n", targets[t], n);
+            return NULL;
+        }
+    }
+    if (options->omega <= 0 || options->omega >= 2) {
+        fprintf(stderr, "Error: The relaxation factor must be between 0 and 2\n");
+        return NULL;
+    }
+    // predecessors of every vertex, as one array (count, then fill)
+    int *pred_offsets = calloc(n + 1, sizeof(int));
+    if (pred_offsets == NULL) {
+        hitting_alloc_error();
+        return NULL;
+    }
+    for (int v = 0; v < n; v++) {
+        for (cell *e = graph->array[v].head; e != NULL; e = e->next) pred_offsets[e->arr]++;
+    }
+    for (int v = 0; v < n; v++) pred_offsets[v + 1] += pred_offsets[v];
+    int *preds = malloc((pred_offsets[n] > 0 ? pred_offsets[n] : 1) * sizeof(int));
+    int *fill = malloc((n > 0 ? n : 1) * sizeof(int));
+    int *queue = malloc((n > 0 ? n : 1) * sizeof(int));
+    char *in_target = calloc(n + 1, 1);
+    char *can_reach = calloc(n + 1, 1);
+    char *may_miss = calloc(n + 1, 1);
+    char *unknown = calloc(n + 1, 1);
+    int *vertex_to_class = create_vertex_to_class(partition, n);
+    int *class_start = calloc(partition->size + 1, sizeof(int));
+    int *sweep_order = malloc((n > 0 ? n : 1) * sizeof(int));
+    t_hitting_result *result = calloc(1, sizeof(t_hitting_result));
+    if (result != NULL) {
+        result->probability = calloc(n + 1, sizeof(double));
+        result->expected_steps = calloc(n + 1, sizeof(double));
+    }
+    if (preds == NULL || fill == NULL || queue == NULL || in_target == NULL || can_reach == NULL ||
+        may_miss == NULL || unknown == NULL || vertex_to_class == NULL || class_start == NULL ||
+        sweep_order == NULL || result == NULL || result->probability == NULL ||
+        result->expected_steps == NULL) {
+        hitting_alloc_error();
+        free(pred_offsets);
+        free(preds);
+        free(fill);
+        free(queue);
+        free(in_target);
+        free(can_reach);
+        free(may_miss);
+        free(unknown);
+        free(vertex_to_class);
+        free(class_start);
+        free(sweep_order);
+        free_hitting_result(result);
+        return NULL;
+    }
+    for (int v = 0; v < n; v++) fill[v] = pred_offsets[v];
+    for (int v = 0; v < n; v++) {
+        for (cell *e = graph->array[v].head; e != NULL; e = e->next) preds[fill[e->arr - 1]++] = v;
+    }
+    result->size = n;
+    for (int t = 0; t < nb_targets; t++) {
+        in_target[targets[t] - 1] = 1;
+        can_reach[targets[t] - 1] = 1;
+    }
+    // pruning: who can reach T at all, then who can get stuck away from T
+    int nb_reaching = backward_search(pred_offsets, preds, n, can_reach, NULL, queue);
+    // vertices that reach T grouped by class, each group in breadth-first order from T
+    for (int k = 0; k < nb_reaching; k++) class_start[vertex_to_class[queue[k]] + 1]++;
+    for (int c = 0; c < partition->size; c++) class_start[c + 1] += class_start[c];
+    for (int c = 0; c < partition->size; c++) fill[c] = class_start[c];
+    for (int k = 0; k < nb_reaching; k++) sweep_order[fill[vertex_to_class[queue[k]]]++] = queue[k];
+    for (int v = 0; v < n; v++) may_miss[v] = !can_reach[v];
+    backward_search(pred_offsets, preds, n, may_miss, in_target, queue);
+    result->converged = 1;
+    for (int v = 0; v < n; v++) {
+        if (in_target[v] || !may_miss[v]) result->probability[v] = 1;
+        if (!can_reach[v]) result->nb_pruned++;
+        if (can_reach[v] && !in_target[v]) result->nb_solved++;
+    }
+    // probabilities where T may be missed, then expected times where it may not, classes sinks first
+    for (int system = 0; system < 2; system++) {
+        double *x = (system == 0) ? result->probability : result->expected_steps;
+        for (int v = 0; v < n; v++) unknown[v] = !in_target[v] && can_reach[v] && (may_miss[v] == (system == 0));
+        for (int c = 0; c < partition->size; c++) {
+            int sweeps = solve_class(graph, &sweep_order[class_start[c]], class_start[c + 1] - class_start[c],
+                                     unknown, system, options, x, &result->residual);
+            result->iterations += sweeps;
+            if (sweeps >= options->max_iterations) result->converged = 0;
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        if (may_miss[v]) result->expected_steps[v] = -1;
+    }
+    free(pred_offsets);
+    free(preds);
+    free(fill);
+    free(queue);
+    free(in_target);
+    free(can_reach);
+    free(may_miss);
+    free(unknown);
+    free(vertex_to_class);
+    free(class_start);
+    free(sweep_order);
+    return result;
+}
+
+// Function that displays hitting probabilities and times
+void display_hitting_result(const t_hitting_result *result) {
+    for (int v = 0; v < result->size; v++) {
+        if (result->expected_steps[v] >= 0) {
+            printf("  State %d: probability %.4f, expected steps %.2f\n", v + 1,
+                   result->probability[v], result->expected_steps[v]);
+        } else {
+            printf("  State %d: probability %.4f, expected steps infinite\n", v + 1, result->probability[v]);
+        }
+    }
+    printf("%d state(s) pruned, %d solved in %d sweep(s), last change %.2e (%s)\n",
+           result->nb_pruned, result->nb_solved, result->iterations, result->residual,
+           result->converged ? "converged" : "not converged");
+}
+
+// Function that frees hitting probabilities and times
+void free_hitting_result(t_hitting_result *result) {
+    if (result == NULL) return;
+    free(result->probability);
+    free(result->expected_steps);
+    free(result);
+}
@@ -0,0 +1,34 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef HITTING_H
+#define HITTING_H
+#include "functions.h"
+
+// Parameters of the iterative solver
+typedef struct {
+    double omega;           // Relaxation factor (1 = Gauss-Seidel, between 1 and 2 = over-relaxation)
+    double tolerance;       // Stop when no value moves by more than this in one sweep
+    int max_iterations;     // Maximum number of sweeps over one class
+} t_hitting_options;
+
+// Hitting probabilities and expected hitting times of a target set
+typedef struct {
+    int size;                   // Number of vertices
+    double *probability;        // Probability of ever reaching the target set from each vertex
+    double *expected_steps;     // Expected number of steps to reach it (-1 when it may never be reached)
+    int nb_pruned;              // Vertices that cannot reach the target set (probability 0 without solving)
+    int nb_solved;              // Vertices left to the iterative solver
+    int iterations;             // Total number of sweeps, over all classes and both systems
+    double residual;            // Largest change of the last sweep of any class
+    int converged;              // 1 if every class reached the tolerance
+} t_hitting_result;
+
+t_hitting_result* hitting_analysis(a_list *, t_partition *, const int *, int, const t_hitting_options *);
+
+void display_hitting_result(const t_hitting_result *);
+
+void free_hitting_result(t_hitting_result *);
+
+#endif //HITTING_H
@@ -0,0 +1,228 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "limit.h"
+
+// Limit matrix computed class by class instead of squaring the whole n x n matrix:
+// - each persistent class c gets its stationary distribution pi_c from its own block,
+// - each transient class gets its absorption probabilities into every persistent class,
+//   from its own block and the already known absorption of the classes it leads to,
+// - row i of the limit is then a_i(c) * pi_c(j) for every state j of every persistent class c.
+// The cost is the sum of the cubes of the class sizes plus one pass over the edges.
+// For periodic classes lim P^n does not exist: the result is then the Cesaro limit.
+
+
+// Solve a * x = b by Gaussian elimination with partial pivoting (a is m x m, b is m x nrhs,
+// both row-major, x replaces b). Returns 0 if the matrix is singular
+static int solve_linear_system(double *a, double *b, int m, int nrhs) {
+    for (int col = 0; col < m; col++) {
+        int pivot = col;
+        for (int r = col + 1; r < m; r++) {
+            double x = a[(size_t)r * m + col];
+            double y = a[(size_t)pivot * m + col];
+            if ((x < 0 ? -x : x) > (y < 0 ? -y : y)) pivot = r;
+        }
+        double p = a[(size_t)pivot * m + col];
+        if (p > -1e-12 && p < 1e-12) return 0;
+        if (pivot != col) {
+            for (int k = 0; k < m; k++) {
+                double swap = a[(size_t)col * m + k];
+                a[(size_t)col * m + k] = a[(size_t)pivot * m + k];
+                a[(size_t)pivot * m + k] = swap;
+            }
+            for (int k = 0; k < nrhs; k++) {
+                double swap = b[(size_t)col * nrhs + k];
+                b[(size_t)col * nrhs + k] = b[(size_t)pivot * nrhs + k];
+                b[(size_t)pivot * nrhs + k] = swap;
+            }
+        }
+        for (int r = col + 1; r < m; r++) {
+            double factor = a[(size_t)r * m + col] / p;
+            if (factor == 0) continue;
+            for (int k = col; k < m; k++) a[(size_t)r * m + k] -= factor * a[(size_t)col * m + k];
+            for (int k = 0; k < nrhs; k++) b[(size_t)r * nrhs + k] -= factor * b[(size_t)col * nrhs + k];
+        }
+    }
+    for (int r = m - 1; r >= 0; r--) {
+        for (int k = 0; k < nrhs; k++) {
+            double sum = b[(size_t)r * nrhs + k];
+            for (int c = r + 1; c < m; c++) sum -= a[(size_t)r * m + c] * b[(size_t)c * nrhs + k];
+            b[(size_t)r * nrhs + k] = sum / a[(size_t)r * m + r];
+        }
+    }
+    return 1;
+}
+
+// Function that builds the block of one class straight from the graph (same result as subMatrix
+// on the transition matrix, without building the n x n matrix)
+matrix* class_block(a_list *graph, t_class *cls) {
+    matrix *block = create_zero_matrix(cls->size);
+    int *local = malloc(graph->size * sizeof(int));
+    if (block == NULL || local == NULL) {
+        fprintf(stderr, "Memory allocation error for class block (sorry ;()\n");
+        free(local);
+        return block;
+    }
+    for (int v = 0; v < graph->size; v++) local[v] = -1;
+    for (int i = 0; i < cls->size; i++) local[cls->vertices[i].identifier] = i;
+    for (int i = 0; i < cls->size; i++) {
+        for (cell *c = graph->array[cls->vertices[i].identifier].head; c != NULL; c = c->next) {
+            int j = local[c->arr - 1];
+            if (j >= 0) block->data[i][j] += c->proba;
+        }
+    }
+    free(local);
+    return block;
+}
+
+// Function that computes the stationary distribution of an irreducible block (for example a
+// persistent class returned by subMatrix): pi * P = pi with sum(pi) = 1. Returns NULL if singular
+float* stationary_from_submatrix(matrix *block) {
+    int m = block->size;
+    double *a = malloc((size_t)m * m * sizeof(double));
+    double *b = calloc(m, sizeof(double));
+    float *pi = malloc(m * sizeof(float));
+    if (a == NULL || b == NULL || pi == NULL) {
+        fprintf(stderr, "Memory allocation error for stationary distribution (sorry ;()\n");
+        free(a);
+        free(b);
+        free(pi);
+        return NULL;
+    }
+    // (P^T - I) pi = 0, with the last equation replaced by sum(pi) = 1
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < m; j++) {
+            a[(size_t)i * m + j] = block->data[j][i] - (i == j ? 1.0 : 0.0);
+        }
+    }
+    for (int j = 0; j < m; j++) a[(size_t)(m - 1) * m + j] = 1.0;
+    b[m - 1] = 1.0;
+    int ok = solve_linear_system(a, b, m, 1);
+    for (int i = 0; i < m && ok; i++) pi[i] = (float)b[i];
+    free(a);
+    free(b);
+    if (!ok) {
+        fprintf(stderr, "Error: The block has no unique stationary distribution\n");
+        free(pi);
+        return NULL;
+    }
+    return pi;
+}
+
+
+// Function that computes lim P^n class by class and assembles the full limit matrix
+matrix* limit_matrix(a_list *graph, t_partition *partition) {
+    if (graph == NULL || partition == NULL) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return NULL;
+    }
+    int n = graph->size;
+    int nb_classes = partition->size;
+    int *vertex_to_class = create_vertex_to_class(partition, n);
+    int *local = malloc(n * sizeof(int));                       // index of each vertex in its class
+    int *persistent_index = malloc(nb_classes * sizeof(int));   // -1 for transient classes
+    float **pi = calloc(nb_classes, sizeof(float *));           // stationary distribution per persistent class
+    double **absorption = calloc(n, sizeof(double *));          // per transient vertex, one entry per persistent class
+    matrix *limit = create_zero_matrix(n);
+    int ok = (vertex_to_class != NULL && local != NULL && persistent_index != NULL && pi != NULL &&
+              absorption != NULL && limit != NULL);
+    int nb_persistent = 0;
+    if (ok) {
+        for (int c = 0; c < nb_classes; c++) {
+            for (int i = 0; i < partition->classes[c].size; i++) local[partition->classes[c].vertices[i].identifier] = i;
+            persistent_index[c] = 0;
+        }
+        // a class is transient as soon as one of its edges leaves it
+        for (int v = 0; v < n; v++) {
+            for (cell *c = graph->array[v].head; c != NULL; c = c->next) {
+                if (vertex_to_class[c->arr - 1] != vertex_to_class[v]) persistent_index[vertex_to_class[v]] = -1;
+            }
+        }
+        for (int c = 0; c < nb_classes; c++) {
+            if (persistent_index[c] == 0) persistent_index[c] = nb_persistent++;
+        }
+    }
+    // persistent classes: stationary distribution of their own block
+    for (int c = 0; c < nb_classes && ok; c++) {
+        if (persistent_index[c] < 0) continue;
+        matrix *block = class_block(graph, &partition->classes[c]);
+        pi[c] = (block != NULL) ? stationary_from_submatrix(block) : NULL;
+        ok = (pi[c] != NULL);
+        free_matrix(block);
+    }
+    // transient classes, sinks first (the order of compute_partition), so that every class
+    // they lead to is already solved: (I - Q) a = sum over leaving edges of p * a(target)
+    for (int c = 0; c < nb_classes && ok; c++) {
+        if (persistent_index[c] >= 0) continue;
+        t_class *cls = &partition->classes[c];
+        int m = cls->size;
+        double *a = calloc((size_t)m * m, sizeof(double));
+        double *b = calloc((size_t)m * (nb_persistent > 0 ? nb_persistent : 1), sizeof(double));
+        ok = (a != NULL && b != NULL);
+        for (int i = 0; i < m && ok; i++) {
+            a[(size_t)i * m + i] += 1.0;
+            int v = cls->vertices[i].identifier;
+            for (cell *e = graph->array[v].head; e != NULL; e = e->next) {
+                int w = e->arr - 1;
+                int cw = vertex_to_class[w];
+                if (cw == c) {
+                    a[(size_t)i * m + local[w]] -= e->proba;
+                } else if (persistent_index[cw] >= 0) {
+                    b[(size_t)i * nb_persistent + persistent_index[cw]] += e->proba;
+                } else {
+                    for (int k = 0; k < nb_persistent; k++) b[(size_t)i * nb_persistent + k] += e->proba * absorption[w][k];
+                }
+            }
+        }
+        if (ok && !solve_linear_system(a, b, m, nb_persistent)) {
+            fprintf(stderr, "Error: Class %s has a singular block\n", cls->name);
+            ok = 0;
+        }
+        for (int i = 0; i < m && ok; i++) {
+            int v = cls->vertices[i].identifier;
+            absorption[v] = malloc((nb_persistent > 0 ? nb_persistent : 1) * sizeof(double));
+            if (absorption[v] == NULL) {
+                ok = 0;
+                break;
+            }
+            for (int k = 0; k < nb_persistent; k++) absorption[v][k] = b[(size_t)i * nb_persistent + k];
+        }
+        free(a);
+        free(b);
+    }
+    // assemble the limit: persistent rows repeat pi, transient rows mix the pi's
+    for (int i = 0; i < n && ok; i++) {
+        int ci = vertex_to_class[i];
+        for (int c = 0; c < nb_classes; c++) {
+            if (persistent_index[c] < 0) continue;
+            double weight;
+            if (persistent_index[ci] >= 0) {
+                weight = (c == ci) ? 1.0 : 0.0;
+            } else {
+                weight = absorption[i][persistent_index[c]];
+            }
+            if (weight == 0) continue;
+            for (int k = 0; k < partition->classes[c].size; k++) {
+                limit->data[i][partition->classes[c].vertices[k].identifier] = (float)(weight * pi[c][k]);
+            }
+        }
+    }
+    if (pi != NULL) {
+        for (int c = 0; c < nb_classes; c++) free(pi[c]);
+    }
+    if (absorption != NULL) {
+        for (int v = 0; v < n; v++) free(absorption[v]);
+    }
+    free(pi);
+    free(absorption);
+    free(vertex_to_class);
+    free(local);
+    free(persistent_index);
+    if (!ok) {
+        fprintf(stderr, "Error: Could not compute the limit matrix\n");
+        free_matrix(limit);
+        return NULL;
+    }
+    return limit;
+}
@@ -0,0 +1,15 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef LIMIT_H
+#define LIMIT_H
+#include "functions.h"
+
+matrix* class_block(a_list *, t_class *);
+
+float* stationary_from_submatrix(matrix *);
+
+matrix* limit_matrix(a_list *, t_partition *);
+
+#endif //LIMIT_H
@@ -0,0 +1,313 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "lumping.h"
+
+// Coarsest ordinarily lumpable partition by splitter-based refinement (Paige-Tarjan style, in the
+// form used for Markov chains by Derisavi, Hermanns and Sanders):
+// a partition is lumpable when, for every pair of blocks B and S, all the states of B have the same
+// probability of going into S. Starting from the initial labels, a block S is taken as splitter,
+// the probability w(u) of entering S is accumulated over the predecessors u of its states, and
+// every block is split by the value of w. When a block that is not waiting to be used as splitter
+// is split, its largest piece is not queued: its weights follow from the others and the parent.
+// States are kept in one array where every block is contiguous, so splitting only moves states.
+// The quotient chain takes the row of any state of each block (they all give the same weights).
+
+#define LUMP_TOLERANCE 1e-6     // weights closer than this are considered equal
+
+
+// Weight of one touched state, used to sort the states of a block
+typedef struct {
+    double weight;
+    int vertex;
+} t_weighted_vertex;
+
+static int compare_weighted(const void *a, const void *b) {
+    const t_weighted_vertex *x = a;
+    const t_weighted_vertex *y = b;
+    if (x->weight != y->weight) return (x->weight > y->weight) - (x->weight < y->weight);
+    return (x->vertex > y->vertex) - (x->vertex < y->vertex);
+}
+
+// Working state of the refinement
+typedef struct {
+    int *elems;         // States, block after block
+    int *loc;           // Position of each state in elems
+    int *block;         // Current block of each state
+    int *start;         // First position of each block
+    int *end;           // Position after the last state of each block
+    int nb_blocks;
+    int *queue;         // Blocks waiting to be used as splitters
+    int queue_size;
+    char *in_queue;
+} t_refinement;
+
+static void push_splitter(t_refinement *r, int b) {
+    if (!r->in_queue[b]) {
+        r->in_queue[b] = 1;
+        r->queue[r->queue_size++] = b;
+    }
+}
+
+// Split block b, whose touched states sit sorted by weight at its end, into groups of equal weight
+static void split_block(t_refinement *r, int b, int nb_touched, const double *w, t_weighted_vertex *groups_buffer) {
+    int first = r->start[b];
+    int last = r->end[b];
+    int touched_start = last - nb_touched;
+    // touched states of weight ~0 belong with the untouched ones
+    int zero_end = touched_start;
+    while (zero_end < last && w[r->elems[zero_end]] <= LUMP_TOLERANCE) zero_end++;
+    // group boundaries (groups_buffer only holds positions here)
+    int nb_groups = 0;
+    if (zero_end > first) groups_buffer[nb_groups++].vertex = first;
+    for (int p = zero_end; p < last; p++) {
+        if (p == zero_end || w[r->elems[p]] - w[r->elems[p - 1]] > LUMP_TOLERANCE) {
+            groups_buffer[nb_groups++].vertex = p;
+        }
+    }
+    if (nb_groups <= 1) return;
+    int was_queued = r->in_queue[b];
+    int largest = 0;
+    int largest_size = -1;
+    for (int g = 0; g < nb_groups; g++) {
+        int g_end = (g + 1 < nb_groups) ? groups_buffer[g + 1].vertex : last;
+        int size = g_end - groups_buffer[g].vertex;
+        if (size > largest_size) {
+            largest_size = size;
+            largest = g;
+        }
+    }
+    for (int g = 0; g < nb_groups; g++) {
+        int g_start = groups_buffer[g].vertex;
+        int g_end = (g + 1 < nb_groups) ? groups_buffer[g + 1].vertex : last;
+        int id = b;
+        if (g > 0) {
+            id = r->nb_blocks++;
+            r->in_queue[id] = 0;
+            for (int p = g_start; p < g_end; p++) r->block[r->elems[p]] = id;
+        }
+        r->start[id] = g_start;
+        r->end[id] = g_end;
+        if (was_queued || g != largest) push_splitter(r, id);
+    }
+}
+
+// Function that computes the coarsest ordinarily lumpable partition refining the labels
+// (one label per vertex, any values; NULL puts every vertex in the same initial block)
+// and builds the quotient chain
+t_lumping* lump_graph(a_list *graph, const int *labels) {
+    if (graph == NULL || graph->array == NULL || graph->size <= 0) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return NULL;
+    }
+    int n = graph->size;
+    t_refinement r;
+    r.elems = malloc(n * sizeof(int));
+    r.loc = malloc(n * sizeof(int));
+    r.block = malloc(n * sizeof(int));
+    r.start = malloc(n * sizeof(int));
+    r.end = malloc(n * sizeof(int));
+    r.queue = malloc(n * sizeof(int));
+    r.in_queue = calloc(n, 1);
+    r.nb_blocks = 0;
+    r.queue_size = 0;
+    int *pred_offsets = calloc(n + 1, sizeof(int));
+    double *w = malloc(n * sizeof(double));
+    int *mark = malloc(n * sizeof(int));
+    int *touched = malloc(n * sizeof(int));
+    int *splitter = malloc(n * sizeof(int));
+    int *touched_blocks = malloc(n * sizeof(int));
+    int *nb_moved = calloc(n, sizeof(int));
+    t_weighted_vertex *sorted = malloc(n * sizeof(t_weighted_vertex));
+    t_lumping *lumping = calloc(1, sizeof(t_lumping));
+    int *preds = NULL;
+    float *pred_probas = NULL;
+    int ok = r.elems != NULL && r.loc != NULL && r.block != NULL && r.start != NULL && r.end != NULL &&
+             r.queue != NULL && r.in_queue != NULL && pred_offsets != NULL && w != NULL && mark != NULL &&
+             touched != NULL && splitter != NULL && touched_blocks != NULL && nb_moved != NULL &&
+             sorted != NULL && lumping != NULL;
+    if (ok) {
+        // predecessors with their probabilities
+        for (int v = 0; v < n; v++) {
+            for (cell *e = graph->array[v].head; e != NULL; e = e->next) pred_offsets[e->arr]++;
+        }
+        for (int v = 0; v < n; v++) pred_offsets[v + 1] += pred_offsets[v];
+        int nb_edges = pred_offsets[n];
+        preds = malloc((nb_edges > 0 ? nb_edges : 1) * sizeof(int));
+        pred_probas = malloc((nb_edges > 0 ? nb_edges : 1) * sizeof(float));
+        ok = preds != NULL && pred_probas != NULL;
+    }
+    if (ok) {
+        for (int v = 0; v < n; v++) mark[v] = pred_offsets[v];
+        for (int v = 0; v < n; v++) {
+            for (cell *e = graph->array[v].head; e != NULL; e = e->next) {
+                int slot = mark[e->arr - 1]++;
+                preds[slot] = v;
+                pred_probas[slot] = e->proba;
+            }
+        }
+        // initial blocks: one per label
+        for (int v = 0; v < n; v++) {
+            sorted[v].weight = (labels != NULL) ? labels[v] : 0;
+            sorted[v].vertex = v;
+        }
+        qsort(sorted, n, sizeof(t_weighted_vertex), compare_weighted);
+        for (int p = 0; p < n; p++) {
+            int v = sorted[p].vertex;
+            if (p == 0 || sorted[p].weight != sorted[p - 1].weight) {
+                if (r.nb_blocks > 0) r.end[r.nb_blocks - 1] = p;
+                r.start[r.nb_blocks] = p;
+                push_splitter(&r, r.nb_blocks);
+                r.nb_blocks++;
+            }
+            r.elems[p] = v;
+            r.loc[v] = p;
+            r.block[v] = r.nb_blocks - 1;
+        }
+        r.end[r.nb_blocks - 1] = n;
+        for (int v = 0; v < n; v++) mark[v] = -1;
+        int stamp = 0;
+        while (r.queue_size > 0) {
+            int s = r.queue[--r.queue_size];
+            r.in_queue[s] = 0;
+            stamp++;
+            // the splitter may be split below: work on a copy of its states
+            int splitter_size = r.end[s] - r.start[s];
+            memcpy(splitter, &r.elems[r.start[s]], splitter_size * sizeof(int));
+            int nb_touched = 0;
+            for (int k = 0; k < splitter_size; k++) {
+                int v = splitter[k];
+                for (int p = pred_offsets[v]; p < pred_offsets[v + 1]; p++) {
+                    int u = preds[p];
+                    if (mark[u] != stamp) {
+                        mark[u] = stamp;
+                        w[u] = 0;
+                        touched[nb_touched++] = u;
+                    }
+                    w[u] += pred_probas[p];
+                }
+            }
+            // move the touched states to the end of their block
+            int nb_touched_blocks = 0;
+            for (int k = 0; k < nb_touched; k++) {
+                int u = touched[k];
+                int b = r.block[u];
+                if (nb_moved[b] == 0) touched_blocks[nb_touched_blocks++] = b;
+                int target = r.end[b] - 1 - nb_moved[b]++;
+                int other = r.elems[target];
+                r.elems[r.loc[u]] = other;
+                r.loc[other] = r.loc[u];
+                r.elems[target] = u;
+                r.loc[u] = target;
+            }
+            for (int k = 0; k < nb_touched_blocks; k++) {
+                int b = touched_blocks[k];
+                int count = nb_moved[b];
+                int base = r.end[b] - count;
+                for (int p = 0; p < count; p++) {
+                    sorted[p].vertex = r.elems[base + p];
+                    sorted[p].weight = w[sorted[p].vertex];
+                }
+                qsort(sorted, count, sizeof(t_weighted_vertex), compare_weighted);
+                for (int p = 0; p < count; p++) {
+                    r.elems[base + p] = sorted[p].vertex;
+                    r.loc[sorted[p].vertex] = base + p;
+                }
+                nb_moved[b] = 0;
+                split_block(&r, b, count, w, sorted);
+            }
+        }
+        // blocks numbered by their smallest vertex, members in increasing order
+        lumping->nb_states = n;
+        lumping->nb_blocks = r.nb_blocks;
+        lumping->block_of = malloc(n * sizeof(int));
+        lumping->block_start = calloc(r.nb_blocks + 1, sizeof(int));
+        lumping->members = malloc(n * sizeof(int));
+        ok = lumping->block_of != NULL && lumping->block_start != NULL && lumping->members != NULL;
+    }
+    if (ok) {
+        int *renumber = mark;
+        for (int b = 0; b < r.nb_blocks; b++) renumber[b] = -1;
+        int next = 0;
+        for (int v = 0; v < n; v++) {
+            if (renumber[r.block[v]] < 0) renumber[r.block[v]] = next++;
+            lumping->block_of[v] = renumber[r.block[v]];
+            lumping->block_start[lumping->block_of[v] + 1]++;
+        }
+        for (int b = 0; b < r.nb_blocks; b++) lumping->block_start[b + 1] += lumping->block_start[b];
+        for (int b = 0; b < r.nb_blocks; b++) touched[b] = lumping->block_start[b];
+        for (int v = 0; v < n; v++) lumping->members[touched[lumping->block_of[v]]++] = v;
+        // quotient chain from one representative per block
+        a_list *quotient = create_a_list(r.nb_blocks);
+        lumping->quotient = *quotient;
+        free(quotient);
+        for (int b = 0; b < r.nb_blocks; b++) {
+            int representative = lumping->members[lumping->block_start[b]];
+            for (cell *e = graph->array[representative].head; e != NULL; e = e->next) {
+                insert_cell(&lumping->quotient.array[b], lumping->block_of[e->arr - 1] + 1, e->proba);
+            }
+        }
+    }
+    free(r.elems);
+    free(r.loc);
+    free(r.block);
+    free(r.start);
+    free(r.end);
+    free(r.queue);
+    free(r.in_queue);
+    free(pred_offsets);
+    free(preds);
+    free(pred_probas);
+    free(w);
+    free(mark);
+    free(touched);
+    free(splitter);
+    free(touched_blocks);
+    free(nb_moved);
+    free(sorted);
+    if (!ok) {
+        fprintf(stderr, "Memory allocation error for lumping (sorry ;()\n");
+        free_lumping(lumping);
+        return NULL;
+    }
+    return lumping;
+}
+
+// Function that gives every original vertex the value computed for its block on the quotient
+// (hitting probabilities or times of a union of blocks, rewards, ...)
+void lift_values(const t_lumping *lumping, const double *block_values, double *state_values) {
+    for (int v = 0; v < lumping->nb_states; v++) state_values[v] = block_values[lumping->block_of[v]];
+}
+
+// Function that gives the distribution over the blocks of a distribution over the original vertices
+void aggregate_distribution(const t_lumping *lumping, const float *distribution, float *block_distribution) {
+    for (int b = 0; b < lumping->nb_blocks; b++) block_distribution[b] = 0;
+    for (int v = 0; v < lumping->nb_states; v++) block_distribution[lumping->block_of[v]] += distribution[v];
+}
+
+// Function that displays the blocks of a lumping
+void display_lumping(const t_lumping *lumping) {
+    for (int b = 0; b < lumping->nb_blocks; b++) {
+        printf("Block %d: {", b + 1);
+        for (int k = lumping->block_start[b]; k < lumping->block_start[b + 1]; k++) {
+            printf("%d", lumping->members[k] + 1);
+            if (k < lumping->block_start[b + 1] - 1) printf(",");
+        }
+        printf("}\n");
+    }
+    printf("%d states lumped into %d blocks\n", lumping->nb_states, lumping->nb_blocks);
+}
+
+// Function that frees a lumping and its quotient chain
+void free_lumping(t_lumping *lumping) {
+    if (lumping == NULL) return;
+    free(lumping->block_of);
+    free(lumping->block_start);
+    free(lumping->members);
+    if (lumping->quotient.array != NULL) {
+        for (int b = 0; b < lumping->quotient.size; b++) free_list(&lumping->quotient.array[b]);
+        free(lumping->quotient.array);
+    }
+    free(lumping);
+}
@@ -0,0 +1,29 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef LUMPING_H
+#define LUMPING_H
+#include "functions.h"
+
+// Coarsest ordinarily lumpable partition of a graph and its quotient chain
+typedef struct {
+    int nb_states;          // Number of vertices of the original graph
+    int nb_blocks;          // Number of blocks (vertices of the quotient)
+    int *block_of;          // Block (0-based) of each original vertex (0-based)
+    int *block_start;       // Start of each block in members (nb_blocks + 1 entries)
+    int *members;           // Original vertices (0-based), block after block
+    a_list quotient;        // Quotient chain: vertex b+1 stands for block b
+} t_lumping;
+
+t_lumping* lump_graph(a_list *, const int *);
+
+void lift_values(const t_lumping *, const double *, double *);
+
+void aggregate_distribution(const t_lumping *, const float *, float *);
+
+void display_lumping(const t_lumping *);
+
+void free_lumping(t_lumping *);
+
+#endif //LUMPING_H
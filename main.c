@@ -1,5 +1,22 @@
 #include <stdio.h>
 #include "functions.h"
+#include "dynamic.h"
+#include "simulation.h"
+#include "distribution.h"
+#include "permutation.h"
+#include "compressed.h"
+#include "limit.h"
+#include "reachability.h"
+#include "hitting.h"
+#include "validation.h"
+#include "cache.h"
+#include "lumping.h"
+#include "paths.h"
+#include "spectral.h"
+#include "ctmc.h"
+#include "sparse.h"
+#include "diff.h"
+#include "stationary.h"
 
 
 int main() {
@@ -19,13 +36,23 @@ int main() {
         else {
                 printf("\nThe graph is not valid\n");
         }
+        // full defect report on the loaded graph (every vertex, not only the first bad one)
+        t_validation_report *validation = validate_graph(&list, 0.01);
+        if (validation != NULL) {
+                display_validation_report(validation);
+                free_validation_report(validation);
+        }
         export_graph(&list, "C:/Users/USER/Downloads/TI_301_PRJ_STUDENTS-master/ex.txt");  // Export for visualization
         printf("\nTarjan Algorithm - Strongly Connected Components:\n");
         tarjan(&list);  // find and display strongly connected components
         t_partition partition = compute_partition(&list);  // stor component partition
         printf("\n");
-        int **class_links = Hasse(&list, &partition);  // build Hasse diagram of components
-        analyze_graph_characteristics(&partition, class_links, partition.size);  // analyze transient/persistent states
+        int **class_links = Hasse(&list, &partition);  // build and display Hasse diagram of components
+        for (int c = 0; c < partition.size; c++) free(class_links[c]);
+        free(class_links);
+        t_classification classification = classify_graph(&list);  // transient/persistent states in one traversal
+        display_classification(&classification);
+        free_classification(&classification);
         printf("\nMatrix Functions Test:\n");
         matrix *transition_mat = create_transition_matrix(&list);  // Create probability matrix
         matrix *zero_mat = create_zero_matrix(list.size);  // Create zero matrix
@@ -38,14 +65,269 @@ int main() {
         copy_matrix(copied_mat, transition_mat);  // test matrix copying
         float diff3 = matrix_difference(transition_mat, copied_mat);  // verify the copy's accuracy
         printf("Difference after copy (should be 0): %.4f\n", diff3);
+        printf("\nSparse Matrix Test:\n");
+        // P^2 without the n^2 storage, compared with the dense product
+        t_sparse_matrix *sparse_mat = sparse_from_graph(&list);
+        t_sparse_matrix *sparse_squared = sparse_multiply(sparse_mat, sparse_mat, 0);
+        if (sparse_squared != NULL) {
+                matrix *expanded = sparse_to_dense(sparse_squared);
+                printf("P has %d entries, P^2 has %d entries (%zu bytes instead of %zu)\n", sparse_mat->nb_entries,
+                       sparse_squared->nb_entries, sparse_memory(sparse_squared),
+                       (size_t)list.size * list.size * sizeof(float));
+                printf("Difference between sparse and dense P^2: %.4f\n", matrix_difference(expanded, squared_mat));
+                free_matrix(expanded);
+                free_sparse_matrix(sparse_squared);
+        }
+        free_sparse_matrix(sparse_mat);
         printf("\nSubMatrix Test:\n");
-        // extract and display the component submatrixes
+        // display the component submatrixes through views (nothing is copied)
         for (int i = 0; i < partition.size; i++) {
-                matrix *submat = subMatrix(transition_mat, &partition, i);
-                if (submat != NULL) {
-                        printf("Component %s: submatrix size %dx%d\n",
-                               partition.classes[i].name, submat->size, submat->size);
+                t_submatrix_view view = subMatrix_view(transition_mat, &partition, i);
+                if (view.parent != NULL) {
+                        printf("Component %s: submatrix size %dx%d, first entry %.2f\n",
+                               partition.classes[i].name, view.size, view.size, view_get(&view, 0, 0));
+                }
+        }
+        // copy of all the blocks at once, when a copy is really needed
+        t_class_blocks *blocks = extract_class_blocks(transition_mat, &partition);
+        if (blocks != NULL) {
+                printf("All blocks extracted in one buffer (%zu values)\n", blocks->offsets[blocks->nb_blocks]);
+                free_class_blocks(blocks);
+        }
+        printf("\nDynamic Mode Test:\n");
+        // edit the graph and let the partition follow without recomputing it
+        t_dynamic_graph *dynamic = create_dynamic_graph(&list);
+        dynamic_remove_edge(dynamic, 4, 1);  // may split a class
+        display_dynamic_graph(dynamic);
+        dynamic_add_edge(dynamic, 4, 1, 1.0f);  // closes the cycle again
+        display_dynamic_graph(dynamic);
+        free_dynamic_graph(dynamic);
+        printf("\nSimulation Test:\n");
+        // 10000 walks of 100 steps from state 1, measuring the time to reach state 4
+        t_simulation_options sim_options = {10000, 100, 1, 4, 2025, 0};
+        t_simulation_result *simulation = simulate_walks(&list, &partition, &sim_options);
+        if (simulation != NULL) {
+                display_simulation_result(simulation, &partition);
+                free_simulation_result(simulation);
+        }
+        printf("\nDistribution Test:\n");
+        // start from state 1 and look at the distribution after 1, 2 and 10 steps
+        float *initial = calloc(list.size, sizeof(float));
+        int times[] = {1, 2, 10};
+        initial[0] = 1.0f;
+        t_distribution_snapshots *snapshots = evolve_distribution(&list, initial, times, 3);
+        if (snapshots != NULL) {
+                display_distribution_snapshots(snapshots);
+                free_distribution_snapshots(snapshots);
+        }
+        free(initial);
+        printf("\nBlock Ordering Test:\n");
+        // relabel the states class by class so that P becomes block upper-triangular
+        int *block_start = malloc((partition.size + 1) * sizeof(int));
+        t_permutation *class_order = class_order_permutation(&partition, list.size, block_start);
+        if (class_order != NULL) {
+                for (int b = 0; b < partition.size; b++) {
+                        printf("Block %d (class %s): new states %d to %d\n", b + 1,
+                               partition.classes[partition.size - 1 - b].name, block_start[b] + 1, block_start[b + 1]);
+                }
+                matrix *block_mat = permute_matrix(transition_mat, class_order);
+                float below = 0;  // probability left of the diagonal blocks
+                for (int b = 0; b < partition.size; b++) {
+                        for (int i = block_start[b]; i < block_start[b + 1]; i++) {
+                                for (int j = 0; j < block_start[b]; j++) below += block_mat->data[i][j];
+                        }
+                }
+                printf("Probability below the diagonal blocks (should be 0): %.4f\n", below);
+                free_matrix(block_mat);
+                free_permutation(class_order);
+        }
+        free(block_start);
+        printf("\nCompressed Graph Test:\n");
+        // 16-bit fixed-point probabilities, partition computed directly on the compressed form
+        t_compressed_graph *compressed = compress_graph(&list, PROBA_FIXED16);
+        if (compressed != NULL) {
+                t_partition compressed_partition = compute_partition_compressed(compressed);
+                printf("Adjacency list: %zu bytes, compressed: %zu bytes, %d classes found\n",
+                       a_list_memory(&list), compressed_graph_memory(compressed), compressed_partition.size);
+                for (int c = 0; c < compressed_partition.size; c++) {
+                        free(compressed_partition.classes[c].name);
+                        free(compressed_partition.classes[c].vertices);
+                }
+                free(compressed_partition.classes);
+                free_compressed_graph(compressed);
+        }
+        printf("\nLimit Matrix Test:\n");
+        // class by class limit, compared with P^1024 obtained by squaring
+        matrix *limit = limit_matrix(&list, &partition);
+        matrix *power = transition_mat;
+        for (int i = 0; i < 10 && power != NULL; i++) {
+                matrix *squared = multiply_matrices(power, power);
+                if (power != transition_mat) free_matrix(power);  // P belongs to the matrix test
+                power = squared;
+        }
+        if (limit != NULL && power != NULL) {
+                printf("Difference between the limit and P^1024: %.4f\n", matrix_difference(limit, power));
+        }
+        if (power != transition_mat) free_matrix(power);
+        free_matrix(limit);
+        printf("\nReachability Test:\n");
+        // every pair of states answered from the index, without any graph search
+        t_reach_index *reach = create_reach_index(&list, &partition, REACH_AUTO);
+        if (reach != NULL) {
+                int nb_pairs = list.size * list.size;
+                int *from = malloc(nb_pairs * sizeof(int));
+                int *to = malloc(nb_pairs * sizeof(int));
+                int *answers = malloc(nb_pairs * sizeof(int));
+                for (int q = 0; q < nb_pairs; q++) {
+                        from[q] = q / list.size + 1;
+                        to[q] = q % list.size + 1;
+                }
+                reach_query_batch(reach, from, to, nb_pairs, answers);
+                int nb_reachable = 0;
+                for (int q = 0; q < nb_pairs; q++) nb_reachable += answers[q];
+                printf("State 1 can reach state %d: %s\n", list.size, reach_query(reach, 1, list.size) ? "yes" : "no");
+                printf("%d reachable pairs out of %d (%s index, %zu bytes)\n", nb_reachable, nb_pairs,
+                       reach->method == REACH_BITSET ? "bitset" : "interval", reach_index_memory(reach));
+                free(from);
+                free(to);
+                free(answers);
+                free_reach_index(reach);
+        }
+        printf("\nHitting Test:\n");
+        // probability and expected time to reach the last state, solved on the sparse graph
+        int hitting_targets[] = {list.size};
+        t_hitting_options hitting_options = {1.2, 1e-9, 100000};
+        t_hitting_result *hitting = hitting_analysis(&list, &partition, hitting_targets, 1, &hitting_options);
+        if (hitting != NULL) {
+                display_hitting_result(hitting);
+                free_hitting_result(hitting);
+        }
+        printf("\nCache Test:\n");
+        // the second call finds the analysis stored by the first one (same file content)
+        for (int run = 0; run < 2; run++) {
+                t_cached_analysis *cached = analyse_with_cache("C:/Users/USER/Downloads/TI_301_PRJ_STUDENTS-master/data/exemple1.txt", ".", 1);
+                if (cached != NULL) {
+                        printf("Run %d: %d classes, %d class links, %d persistent (%s)\n", run + 1,
+                               cached->classification.partition.size, cached->nb_links,
+                               cached->classification.nb_persistent, cached->from_cache ? "from the cache" : "computed");
+                        free_cached_analysis(cached);
+                }
+        }
+        printf("\nLumping Test:\n");
+        // keep the last state apart, lump the rest, then solve the hitting problem on the quotient
+        int *lump_labels = calloc(list.size, sizeof(int));
+        lump_labels[list.size - 1] = 1;
+        t_lumping *lumping = lump_graph(&list, lump_labels);
+        if (lumping != NULL) {
+                display_lumping(lumping);
+                t_partition quotient_partition = compute_partition(&lumping->quotient);
+                int quotient_targets[] = {lumping->block_of[list.size - 1] + 1};
+                t_hitting_result *quotient_hitting = hitting_analysis(&lumping->quotient, &quotient_partition,
+                                                                      quotient_targets, 1, NULL);
+                if (quotient_hitting != NULL) {
+                        double *lifted = malloc(list.size * sizeof(double));
+                        lift_values(lumping, quotient_hitting->expected_steps, lifted);
+                        printf("Expected steps from state 1 to state %d, solved on the quotient: %.2f\n",
+                               list.size, lifted[0]);
+                        free(lifted);
+                        free_hitting_result(quotient_hitting);
+                }
+                for (int c = 0; c < quotient_partition.size; c++) {
+                        free(quotient_partition.classes[c].name);
+                        free(quotient_partition.classes[c].vertices);
+                }
+                free(quotient_partition.classes);
+                free_lumping(lumping);
+        }
+        free(lump_labels);
+        printf("\nPaths Test:\n");
+        // most probable way from the first state to the last one, then the next best alternatives
+        t_reach_index *path_reach = create_reach_index(&list, &partition, REACH_AUTO);
+        t_path_engine *path_engine = create_path_engine(&list, path_reach);
+        if (path_engine != NULL) {
+                t_path best_path;
+                if (most_probable_path(path_engine, 1, list.size, &best_path) == 1) {
+                        display_path(&best_path);
+                        free_path(&best_path);
+                } else {
+                        printf("State %d cannot be reached from state 1\n", list.size);
+                }
+                t_path_set *best_paths = k_most_probable_paths(path_engine, 1, list.size, 3);
+                if (best_paths != NULL) {
+                        for (int p = 0; p < best_paths->nb_paths; p++) {
+                                printf("#%d: ", p + 1);
+                                display_path(&best_paths->paths[p]);
+                        }
+                        free_path_set(best_paths);
+                }
+                free_path_engine(path_engine);
+        }
+        free_reach_index(path_reach);
+        printf("\nSpectral Test:\n");
+        // how fast each persistent class forgets where it started
+        t_spectral_report *spectral = spectral_analysis(&list, &partition, NULL);
+        if (spectral != NULL) {
+                display_spectral_report(spectral, &partition);
+                free_spectral_report(spectral);
+        }
+        printf("\nContinuous-Time Test:\n");
+        // same file read as rates: classes of the jump chain, then the distribution at t = 2
+        t_read_options rate_options = {0, 1};
+        a_list rates = readGraphWithOptions("C:/Users/USER/Downloads/TI_301_PRJ_STUDENTS-master/data/exemple1.txt", &rate_options);
+        a_list jump_chain = embedded_chain(&rates);
+        t_partition jump_partition = compute_partition(&jump_chain);
+        printf("The embedded chain has %d classes\n", jump_partition.size);
+        double *start = calloc(rates.size, sizeof(double));
+        start[0] = 1;
+        t_ctmc_transient *transient = ctmc_transient(&rates, start, 2.0, 1e-8);
+        if (transient != NULL) {
+                display_ctmc_transient(transient);
+                free_ctmc_transient(transient);
+        }
+        free(start);
+        for (int c = 0; c < jump_partition.size; c++) {
+                free(jump_partition.classes[c].name);
+                free(jump_partition.classes[c].vertices);
+        }
+        free(jump_partition.classes);
+        for (int v = 0; v < rates.size; v++) {
+                free_list(&rates.array[v]);
+                free_list(&jump_chain.array[v]);
+        }
+        free(rates.array);
+        free(jump_chain.array);
+        printf("\nDiff Test:\n");
+        // a second version of the chain where state 1 moves its first edge to the last state
+        a_list today = readGraph("C:/Users/USER/Downloads/TI_301_PRJ_STUDENTS-master/data/exemple1.txt");
+        cell *moved_edge = today.array[0].head;
+        float moved_proba = moved_edge->proba;
+        remove_cell(&today.array[0], moved_edge->arr);
+        insert_cell(&today.array[0], today.size, moved_proba);
+        t_partition today_partition = compute_partition(&today);
+        t_chain_diff *diff = diff_chains(&list, &today, &partition, &today_partition, 1e-6f);
+        if (diff != NULL) {
+                display_chain_diff(diff);
+                free_chain_diff(diff);
+        }
+        for (int c = 0; c < today_partition.size; c++) {
+                free(today_partition.classes[c].name);
+                free(today_partition.classes[c].vertices);
+        }
+        free(today_partition.classes);
+        for (int v = 0; v < today.size; v++) free_list(&today.array[v]);
+        free(today.array);
+        printf("\nStationary Update Test:\n");
+        // state 1 gives a little more to state 2; the old distribution is the starting point
+        t_stationary_result *stationary = stationary_distribution(&list, 1e-10);
+        if (stationary != NULL) {
+                display_stationary_result(stationary);
+                t_row_edit edits[2] = {{1, 1, 0.90f}, {1, 2, 0.09f}};
+                t_stationary_result *updated = update_stationary(&list, stationary->distribution, edits, 2, 1e-10);
+                if (updated != NULL) {
+                        display_stationary_result(updated);
+                        free_stationary_result(updated);
                 }
+                free_stationary_result(stationary);
         }
         return 0;
 }
@@ -0,0 +1,421 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "paths.h"
+#include <math.h>
+
+// Most probable paths: the probability of a path is the product of its edge probabilities, so the
+// most probable path is the shortest one for the weights -log(p) >= 0, found by Dijkstra.
+// The search stops as soon as the target is settled, and an optional reachability index lets it
+// ignore every vertex whose class cannot reach the class of the target (and answer at once when the
+// target is not reachable at all). All the arrays are stamped instead of cleared, so a query only
+// costs the part of the graph it explores.
+// The k most probable loopless paths come from Yen's algorithm: each new path deviates from a
+// previous one at a spur vertex, with the root of the path and the already used next edges banned.
+// One backward Dijkstra from the target gives the exact remaining cost of every vertex; the spur
+// searches use it as an A* potential, so they walk almost straight to the target instead of
+// exploring everything closer than it.
+
+
+static void path_alloc_error(void) {
+    fprintf(stderr, "Memory allocation error for path search (sorry ;()\n");
+}
+
+// Function that prepares the path searches on a graph
+// The reachability index of the graph is optional (NULL for none) and must outlive the engine
+t_path_engine* create_path_engine(a_list *graph, const t_reach_index *reach) {
+    if (graph == NULL || graph->array == NULL) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return NULL;
+    }
+    int n = graph->size;
+    t_path_engine *engine = calloc(1, sizeof(t_path_engine));
+    if (engine == NULL) {
+        path_alloc_error();
+        return NULL;
+    }
+    engine->size = n;
+    engine->offsets = calloc(n + 1, sizeof(int));
+    engine->dist = malloc((n > 0 ? n : 1) * sizeof(double));
+    engine->parent = malloc((n > 0 ? n : 1) * sizeof(int));
+    engine->seen = calloc(n > 0 ? n : 1, sizeof(int));
+    engine->banned = calloc(n > 0 ? n : 1, sizeof(int));
+    engine->heap = malloc((n > 0 ? n : 1) * sizeof(int));
+    engine->heap_pos = malloc((n > 0 ? n : 1) * sizeof(int));
+    engine->reach = reach;
+    if (engine->offsets == NULL || engine->dist == NULL || engine->parent == NULL || engine->seen == NULL ||
+        engine->banned == NULL || engine->heap == NULL || engine->heap_pos == NULL) {
+        path_alloc_error();
+        free_path_engine(engine);
+        return NULL;
+    }
+    // edges copied in one array with their weights, edges of probability 0 are left out
+    for (int v = 0; v < n; v++) {
+        engine->offsets[v + 1] = engine->offsets[v];
+        for (cell *e = graph->array[v].head; e != NULL; e = e->next) {
+            if (e->proba > 0 && e->arr - 1 != v) engine->offsets[v + 1]++;
+        }
+    }
+    int nb_edges = engine->offsets[n];
+    engine->targets = malloc((nb_edges > 0 ? nb_edges : 1) * sizeof(int));
+    engine->costs = malloc((nb_edges > 0 ? nb_edges : 1) * sizeof(double));
+    engine->probas = malloc((nb_edges > 0 ? nb_edges : 1) * sizeof(float));
+    if (engine->targets == NULL || engine->costs == NULL || engine->probas == NULL) {
+        path_alloc_error();
+        free_path_engine(engine);
+        return NULL;
+    }
+    for (int v = 0; v < n; v++) {
+        int k = engine->offsets[v];
+        for (cell *e = graph->array[v].head; e != NULL; e = e->next) {
+            if (e->proba <= 0 || e->arr - 1 == v) continue;  // a loop never helps a path
+            engine->targets[k] = e->arr - 1;
+            engine->probas[k] = e->proba;
+            engine->costs[k] = (e->proba < 1) ? -log(e->proba) : 0;
+            k++;
+        }
+    }
+    return engine;
+}
+
+// Function that frees a path engine
+void free_path_engine(t_path_engine *engine) {
+    if (engine == NULL) return;
+    free(engine->offsets);
+    free(engine->targets);
+    free(engine->costs);
+    free(engine->probas);
+    free(engine->dist);
+    free(engine->parent);
+    free(engine->seen);
+    free(engine->banned);
+    free(engine->heap);
+    free(engine->heap_pos);
+    free(engine);
+}
+
+// Heap order: smallest key first, ties broken towards the vertex closest to the target
+static int heap_before(const t_path_engine *engine, const double *key, int u, int v) {
+    if (key[u] != key[v]) return key[u] < key[v];
+    return engine->potential != NULL && engine->potential[u] < engine->potential[v];
+}
+
+static void heap_up(t_path_engine *engine, const double *key, int position) {
+    int v = engine->heap[position];
+    while (position > 0) {
+        int parent = (position - 1) / 2;
+        int u = engine->heap[parent];
+        if (!heap_before(engine, key, v, u)) break;
+        engine->heap[position] = u;
+        engine->heap_pos[u] = position;
+        position = parent;
+    }
+    engine->heap[position] = v;
+    engine->heap_pos[v] = position;
+}
+
+static void heap_down(t_path_engine *engine, const double *key, int position, int heap_size) {
+    int v = engine->heap[position];
+    while (2 * position + 1 < heap_size) {
+        int child = 2 * position + 1;
+        if (child + 1 < heap_size && heap_before(engine, key, engine->heap[child + 1], engine->heap[child])) {
+            child++;
+        }
+        int u = engine->heap[child];
+        if (!heap_before(engine, key, u, v)) break;
+        engine->heap[position] = u;
+        engine->heap_pos[u] = position;
+        position = child;
+    }
+    engine->heap[position] = v;
+    engine->heap_pos[v] = position;
+}
+
+// Dijkstra from source to target (0-based) in the current search: vertices whose banned stamp is
+// the current one are avoided, and so are the edges from the source to the banned_next vertices.
+// With a potential, edges are weighted by their reduced cost c(u,w) + potential[w] - potential[u] (A*)
+static int dijkstra(t_path_engine *engine, int source, int target, const int *banned_next, int nb_banned_next) {
+    int stamp = engine->stamp;
+    int heap_size = 0;
+    engine->seen[source] = stamp;
+    engine->dist[source] = 0;
+    engine->parent[source] = -1;
+    engine->heap[heap_size++] = source;
+    engine->heap_pos[source] = 0;
+    while (heap_size > 0) {
+        int u = engine->heap[0];
+        engine->heap_pos[u] = -1;
+        heap_size--;
+        if (heap_size > 0) {
+            engine->heap[0] = engine->heap[heap_size];
+            heap_down(engine, engine->dist, 0, heap_size);
+        }
+        if (u == target) return 1;  // early termination
+        for (int k = engine->offsets[u]; k < engine->offsets[u + 1]; k++) {
+            int w = engine->targets[k];
+            if (engine->banned[w] == stamp) continue;
+            if (u == source) {
+                int skip = 0;
+                for (int b = 0; b < nb_banned_next && !skip; b++) skip = (banned_next[b] == w);
+                if (skip) continue;
+            }
+            double candidate = engine->dist[u] + engine->costs[k];
+            if (engine->potential != NULL) {
+                double reduced = engine->costs[k] + engine->potential[w] - engine->potential[u];
+                candidate = engine->dist[u] + (reduced > 0 ? reduced : 0);  // >= 0 up to rounding
+            }
+            if (engine->seen[w] != stamp) {
+                engine->seen[w] = stamp;
+                int useless = (engine->potential != NULL) ? engine->potential[w] == INFINITY
+                        : engine->reach != NULL && !reach_query(engine->reach, w + 1, target + 1);
+                if (useless) {
+                    engine->heap_pos[w] = -1;  // pruned: settled without ever being used
+                    continue;
+                }
+                engine->dist[w] = candidate;
+                engine->parent[w] = u;
+                engine->heap[heap_size] = w;
+                heap_up(engine, engine->dist, heap_size++);
+            } else if (engine->heap_pos[w] >= 0 && candidate < engine->dist[w]) {
+                engine->dist[w] = candidate;
+                engine->parent[w] = u;
+                heap_up(engine, engine->dist, engine->heap_pos[w]);
+            }
+        }
+    }
+    return 0;
+}
+
+// Cost of the most probable path from every vertex to target (INFINITY when it cannot be reached),
+// by Dijkstra on the reversed edges. Returns NULL if the memory runs out
+static double* distances_to(t_path_engine *engine, int target) {
+    int n = engine->size;
+    int nb_edges = engine->offsets[n];
+    double *remaining = malloc(n * sizeof(double));
+    int *reverse_offsets = calloc(n + 1, sizeof(int));
+    int *reverse_edges = malloc((nb_edges > 0 ? nb_edges : 1) * sizeof(int));
+    if (remaining == NULL || reverse_offsets == NULL || reverse_edges == NULL) {
+        free(remaining);
+        free(reverse_offsets);
+        free(reverse_edges);
+        return NULL;
+    }
+    // reversed edges stored as indices of the forward ones, grouped by their end
+    for (int k = 0; k < nb_edges; k++) reverse_offsets[engine->targets[k] + 1]++;
+    for (int v = 0; v < n; v++) reverse_offsets[v + 1] += reverse_offsets[v];
+    for (int u = 0; u < n; u++) {
+        for (int k = engine->offsets[u]; k < engine->offsets[u + 1]; k++) {
+            reverse_edges[reverse_offsets[engine->targets[k]]++] = k;
+        }
+    }
+    for (int v = n; v > 0; v--) reverse_offsets[v] = reverse_offsets[v - 1];
+    reverse_offsets[0] = 0;
+    // the source of a forward edge is found back from its index
+    int *sources = malloc((nb_edges > 0 ? nb_edges : 1) * sizeof(int));
+    if (sources == NULL) {
+        free(remaining);
+        free(reverse_offsets);
+        free(reverse_edges);
+        return NULL;
+    }
+    for (int u = 0; u < n; u++) {
+        for (int k = engine->offsets[u]; k < engine->offsets[u + 1]; k++) sources[k] = u;
+    }
+    for (int v = 0; v < n; v++) remaining[v] = INFINITY;
+    int stamp = ++engine->stamp;
+    int heap_size = 0;
+    remaining[target] = 0;
+    engine->seen[target] = stamp;
+    engine->heap[heap_size] = target;
+    heap_up(engine, remaining, heap_size++);
+    while (heap_size > 0) {
+        int w = engine->heap[0];
+        engine->heap_pos[w] = -1;
+        heap_size--;
+        if (heap_size > 0) {
+            engine->heap[0] = engine->heap[heap_size];
+            heap_down(engine, remaining, 0, heap_size);
+        }
+        for (int r = reverse_offsets[w]; r < reverse_offsets[w + 1]; r++) {
+            int k = reverse_edges[r];
+            int u = sources[k];
+            double candidate = remaining[w] + engine->costs[k];
+            if (engine->seen[u] != stamp) {
+                engine->seen[u] = stamp;
+                remaining[u] = candidate;
+                engine->heap[heap_size] = u;
+                heap_up(engine, remaining, heap_size++);
+            } else if (engine->heap_pos[u] >= 0 && candidate < remaining[u]) {
+                remaining[u] = candidate;
+                heap_up(engine, remaining, engine->heap_pos[u]);
+            }
+        }
+    }
+    free(reverse_offsets);
+    free(reverse_edges);
+    free(sources);
+    return remaining;
+}
+
+// Index of the edge u -> v in the engine (-1 if there is none)
+static int find_edge(const t_path_engine *engine, int u, int v) {
+    for (int k = engine->offsets[u]; k < engine->offsets[u + 1]; k++) {
+        if (engine->targets[k] == v) return k;
+    }
+    return -1;
+}
+
+// Fill probability and cost of a path from its edges
+static void evaluate_path(const t_path_engine *engine, t_path *path) {
+    path->probability = 1;
+    path->cost = 0;
+    for (int i = 0; i + 1 < path->length; i++) {
+        int k = find_edge(engine, path->vertices[i] - 1, path->vertices[i + 1] - 1);
+        path->probability *= engine->probas[k];
+        path->cost += engine->costs[k];
+    }
+}
+
+// Path made of the first root_length vertices of root followed by the search path to target
+static int build_path(const t_path_engine *engine, const int *root, int root_length, int target, t_path *path) {
+    int spur_length = 0;
+    for (int v = target; v != -1; v = engine->parent[v]) spur_length++;
+    path->length = root_length + spur_length;
+    path->vertices = malloc(path->length * sizeof(int));
+    if (path->vertices == NULL) return 0;
+    for (int i = 0; i < root_length; i++) path->vertices[i] = root[i];
+    int position = path->length - 1;
+    for (int v = target; v != -1; v = engine->parent[v]) path->vertices[position--] = v + 1;
+    evaluate_path(engine, path);
+    return 1;
+}
+
+// Function that finds the most probable path between two vertices (1-based)
+// Returns 1 if a path was found, 0 if the target cannot be reached, -1 on invalid input
+int most_probable_path(t_path_engine *engine, int from, int to, t_path *path) {
+    path->vertices = NULL;
+    path->length = 0;
+    path->probability = 0;
+    path->cost = 0;
+    if (engine != NULL) engine->potential = NULL;
+    if (engine == NULL || from < 1 || from > engine->size || to < 1 || to > engine->size) {
+        fprintf(stderr, "Error: Invalid vertex for the path search\n");
+        return -1;
+    }
+    if (engine->reach != NULL && !reach_query(engine->reach, from, to)) return 0;
+    engine->stamp++;
+    if (!dijkstra(engine, from - 1, to - 1, NULL, 0)) return 0;
+    if (!build_path(engine, NULL, 0, to - 1, path)) {
+        path_alloc_error();
+        return -1;
+    }
+    return 1;
+}
+
+static int same_vertices(const t_path *a, const t_path *b) {
+    return a->length == b->length && memcmp(a->vertices, b->vertices, a->length * sizeof(int)) == 0;
+}
+
+// Function that finds the k most probable loopless paths between two vertices (1-based),
+// most probable first (fewer than k when there are not that many)
+t_path_set* k_most_probable_paths(t_path_engine *engine, int from, int to, int k) {
+    t_path_set *set = calloc(1, sizeof(t_path_set));
+    if (set == NULL || k < 1) {
+        if (set == NULL) path_alloc_error();
+        return set;
+    }
+    set->paths = malloc(k * sizeof(t_path));
+    if (set->paths == NULL) {
+        path_alloc_error();
+        free(set);
+        return NULL;
+    }
+    t_path first;
+    if (most_probable_path(engine, from, to, &first) != 1) return set;
+    set->paths[set->nb_paths++] = first;
+    t_path *candidates = NULL;
+    int nb_candidates = 0;
+    int capacity = 0;
+    int *banned_next = malloc(k * sizeof(int));
+    double *remaining = (k > 1) ? distances_to(engine, to - 1) : NULL;
+    int failed = (banned_next == NULL || (k > 1 && remaining == NULL));
+    engine->potential = remaining;
+    while (set->nb_paths < k && !failed) {
+        const t_path *previous = &set->paths[set->nb_paths - 1];
+        for (int i = 0; i + 1 < previous->length && !failed; i++) {
+            int spur = previous->vertices[i] - 1;
+            engine->stamp++;
+            // the root may not be visited again, and the spur may not repeat a known deviation
+            for (int r = 0; r < i; r++) engine->banned[previous->vertices[r] - 1] = engine->stamp;
+            int nb_banned_next = 0;
+            for (int p = 0; p < set->nb_paths; p++) {
+                const t_path *known = &set->paths[p];
+                if (known->length > i + 1 && memcmp(known->vertices, previous->vertices, (i + 1) * sizeof(int)) == 0) {
+                    banned_next[nb_banned_next++] = known->vertices[i + 1] - 1;
+                }
+            }
+            if (!dijkstra(engine, spur, to - 1, banned_next, nb_banned_next)) continue;
+            t_path candidate;
+            if (!build_path(engine, previous->vertices, i, to - 1, &candidate)) {
+                failed = 1;
+                break;
+            }
+            int duplicate = 0;
+            for (int c = 0; c < nb_candidates && !duplicate; c++) duplicate = same_vertices(&candidates[c], &candidate);
+            if (duplicate) {
+                free_path(&candidate);
+                continue;
+            }
+            if (nb_candidates >= capacity) {
+                capacity = (capacity > 0) ? 2 * capacity : 16;
+                t_path *grown = realloc(candidates, capacity * sizeof(t_path));
+                if (grown == NULL) {
+                    free_path(&candidate);
+                    failed = 1;
+                    break;
+                }
+                candidates = grown;
+            }
+            candidates[nb_candidates++] = candidate;
+        }
+        if (nb_candidates == 0) break;
+        int best = 0;
+        for (int c = 1; c < nb_candidates; c++) {
+            if (candidates[c].cost < candidates[best].cost) best = c;
+        }
+        set->paths[set->nb_paths++] = candidates[best];
+        candidates[best] = candidates[--nb_candidates];
+    }
+    if (failed) path_alloc_error();
+    for (int c = 0; c < nb_candidates; c++) free_path(&candidates[c]);
+    free(candidates);
+    free(banned_next);
+    engine->potential = NULL;
+    free(remaining);
+    return set;
+}
+
+// Function that displays a path and its probability
+void display_path(const t_path *path) {
+    for (int i = 0; i < path->length; i++) {
+        printf("%d", path->vertices[i]);
+        if (i < path->length - 1) printf(" -> ");
+    }
+    printf("  (probability %.6f)\n", path->probability);
+}
+
+// Function that frees the vertices of a path
+void free_path(t_path *path) {
+    free(path->vertices);
+    path->vertices = NULL;
+    path->length = 0;
+}
+
+// Function that frees a set of paths
+void free_path_set(t_path_set *set) {
+    if (set == NULL) return;
+    for (int p = 0; p < set->nb_paths; p++) free_path(&set->paths[p]);
+    free(set->paths);
+    free(set);
+}
@@ -0,0 +1,56 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef PATHS_H
+#define PATHS_H
+#include "functions.h"
+#include "reachability.h"
+
+// One path of the graph
+typedef struct {
+    int *vertices;          // Vertices of the path (1-based), from the start to the end
+    int length;             // Number of vertices
+    double probability;     // Product of the probabilities of its edges
+    double cost;            // -log(probability), the weight minimised by the search
+} t_path;
+
+// Several paths, most probable first
+typedef struct {
+    t_path *paths;
+    int nb_paths;
+} t_path_set;
+
+// Reusable state of the path searches on one graph (one engine per thread)
+typedef struct {
+    int size;               // Number of vertices
+    int *offsets;           // Edges of each vertex in targets/costs (size + 1 entries)
+    int *targets;           // Edge ends (0-based)
+    double *costs;          // Edge weights -log(p)
+    float *probas;          // Edge probabilities
+    const t_reach_index *reach; // Optional, skips vertices that cannot reach the target (not owned)
+    const double *potential;    // Remaining cost to the target used by the current search (or NULL)
+    double *dist;           // Tentative cost of each vertex (valid when seen == stamp)
+    int *parent;            // Previous vertex on the best known path
+    int *seen;              // Stamp of the search that last reached each vertex
+    int *banned;            // Stamp of the search in which each vertex is forbidden
+    int stamp;              // Current search number (avoids clearing the arrays)
+    int *heap;              // Binary heap of vertices ordered by dist
+    int *heap_pos;          // Position of each vertex in the heap (-1 once settled)
+} t_path_engine;
+
+t_path_engine* create_path_engine(a_list *, const t_reach_index *);
+
+void free_path_engine(t_path_engine *);
+
+int most_probable_path(t_path_engine *, int, int, t_path *);
+
+t_path_set* k_most_probable_paths(t_path_engine *, int, int, int);
+
+void display_path(const t_path *);
+
+void free_path(t_path *);
+
+void free_path_set(t_path_set *);
+
+#endif //PATHS_H
@@ -0,0 +1,378 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "permutation.h"
+
+// Relabelling of the states. Graphs, matrices, partitions and vectors can be moved to the new
+// labels and results brought back with the inverse map.
+// The class order puts each class in consecutive labels, classes in topological order, which
+// makes the transition matrix block upper-triangular (the diagonal blocks are the classes).
+// The locality orders give neighbouring vertices close labels, so that traversals and
+// propagation touch fewer cache lines of graph->array and of the vectors.
+
+
+// Function that builds a permutation from the list of old labels in their new order
+t_permutation* create_permutation(const int *inverse, int size) {
+    t_permutation *perm = malloc(sizeof(t_permutation));
+    if (perm == NULL) {
+        fprintf(stderr, "Memory allocation error for permutation (sorry ;()\n");
+        return NULL;
+    }
+    perm->size = size;
+    perm->forward = malloc(size * sizeof(int));
+    perm->inverse = malloc(size * sizeof(int));
+    if (perm->forward == NULL || perm->inverse == NULL) {
+        fprintf(stderr, "Memory allocation error for permutation (sorry ;()\n");
+        free_permutation(perm);
+        return NULL;
+    }
+    for (int i = 0; i < size; i++) perm->forward[i] = -1;
+    for (int i = 0; i < size; i++) {
+        int old = inverse[i];
+        if (old < 0 || old >= size || perm->forward[old] != -1) {
+            fprintf(stderr, "Error: %d is not a valid permutation entry\n", old);
+            free_permutation(perm);
+            return NULL;
+        }
+        perm->inverse[i] = old;
+        perm->forward[old] = i;
+    }
+    return perm;
+}
+
+// Function that frees a permutation
+void free_permutation(t_permutation *perm) {
+    if (perm == NULL) return;
+    free(perm->forward);
+    free(perm->inverse);
+    free(perm);
+}
+
+// Function that relabels the vertices class by class, classes in topological order
+// compute_partition emits the classes sinks first, so they are taken from the last one.
+// If block_start is not NULL it receives partition->size + 1 entries: block b holds the new
+// labels [block_start[b], block_start[b + 1]) and is class partition->size - 1 - b
+t_permutation* class_order_permutation(t_partition *partition, int nb_vertices, int *block_start) {
+    int *inverse = malloc(nb_vertices * sizeof(int));
+    if (inverse == NULL) {
+        fprintf(stderr, "Memory allocation error for permutation (sorry ;()\n");
+        return NULL;
+    }
+    int next = 0;
+    for (int b = 0; b < partition->size; b++) {
+        t_class *cls = &partition->classes[partition->size - 1 - b];
+        if (block_start != NULL) block_start[b] = next;
+        for (int i = 0; i < cls->size && next < nb_vertices; i++) {
+            inverse[next++] = cls->vertices[i].identifier;
+        }
+    }
+    if (block_start != NULL) block_start[partition->size] = next;
+    if (next != nb_vertices) {
+        fprintf(stderr, "Error: The partition does not cover the %d vertices\n", nb_vertices);
+        free(inverse);
+        return NULL;
+    }
+    t_permutation *perm = create_permutation(inverse, nb_vertices);
+    free(inverse);
+    return perm;
+}
+
+// Undirected neighbours of every vertex in compressed form: neighbours of v are
+// adjacency[start[v]] to adjacency[start[v + 1] - 1] (a vertex may appear twice)
+static int build_undirected(const a_list *graph, int **start, int **adjacency) {
+    int n = graph->size;
+    int *first = calloc(n + 1, sizeof(int));
+    if (first == NULL) return 0;
+    for (int v = 0; v < n; v++) {
+        for (cell *c = graph->array[v].head; c != NULL; c = c->next) {
+            if (c->arr - 1 == v) continue;  // loops do not matter for the order
+            first[v + 1]++;
+            first[c->arr]++;
+        }
+    }
+    for (int v = 0; v < n; v++) first[v + 1] += first[v];
+    int *neighbours = malloc((first[n] > 0 ? first[n] : 1) * sizeof(int));
+    int *fill = malloc((n > 0 ? n : 1) * sizeof(int));
+    if (neighbours == NULL || fill == NULL) {
+        free(first);
+        free(neighbours);
+        free(fill);
+        return 0;
+    }
+    memcpy(fill, first, n * sizeof(int));
+    for (int v = 0; v < n; v++) {
+        for (cell *c = graph->array[v].head; c != NULL; c = c->next) {
+            int w = c->arr - 1;
+            if (w == v) continue;
+            neighbours[fill[v]++] = w;
+            neighbours[fill[w]++] = v;
+        }
+    }
+    free(fill);
+    *start = first;
+    *adjacency = neighbours;
+    return 1;
+}
+
+// Sort vertices by increasing degree (insertion sort, used on the short neighbour lists)
+static void sort_by_degree(int *vertices, int count, const int *start) {
+    for (int i = 1; i < count; i++) {
+        int v = vertices[i];
+        int degree = start[v + 1] - start[v];
+        int j = i - 1;
+        while (j >= 0 && start[vertices[j] + 1] - start[vertices[j]] > degree) {
+            vertices[j + 1] = vertices[j];
+            j--;
+        }
+        vertices[j + 1] = v;
+    }
+}
+
+// Reverse Cuthill-McKee: breadth-first from a low-degree vertex of each component,
+// neighbours taken by increasing degree, and the whole order reversed at the end
+static int rcm_order(const a_list *graph, int *inverse) {
+    int n = graph->size;
+    int *start;
+    int *adjacency;
+    if (!build_undirected(graph, &start, &adjacency)) return 0;
+    int *visited = calloc(n, sizeof(int));
+    int *by_degree = malloc(n * sizeof(int));
+    if (visited == NULL || by_degree == NULL) {
+        free(visited);
+        free(by_degree);
+        free(start);
+        free(adjacency);
+        return 0;
+    }
+    // component roots are tried by increasing degree (counting sort, stable)
+    int max_degree = 0;
+    for (int v = 0; v < n; v++) {
+        if (start[v + 1] - start[v] > max_degree) max_degree = start[v + 1] - start[v];
+    }
+    int *count = calloc(max_degree + 2, sizeof(int));
+    if (count == NULL) {
+        free(visited);
+        free(by_degree);
+        free(start);
+        free(adjacency);
+        return 0;
+    }
+    for (int v = 0; v < n; v++) count[start[v + 1] - start[v] + 1]++;
+    for (int d = 0; d <= max_degree; d++) count[d + 1] += count[d];
+    for (int v = 0; v < n; v++) by_degree[count[start[v + 1] - start[v]]++] = v;
+    free(count);
+    int head = 0;
+    int tail = 0;
+    for (int r = 0; r < n; r++) {
+        int root = by_degree[r];
+        if (visited[root]) continue;
+        visited[root] = 1;
+        inverse[tail++] = root;
+        while (head < tail) {
+            int v = inverse[head++];
+            int first_new = tail;
+            for (int i = start[v]; i < start[v + 1]; i++) {
+                int w = adjacency[i];
+                if (!visited[w]) {
+                    visited[w] = 1;
+                    inverse[tail++] = w;
+                }
+            }
+            sort_by_degree(&inverse[first_new], tail - first_new, start);
+        }
+    }
+    for (int i = 0; i < n / 2; i++) {
+        int swap = inverse[i];
+        inverse[i] = inverse[n - 1 - i];
+        inverse[n - 1 - i] = swap;
+    }
+    free(visited);
+    free(by_degree);
+    free(start);
+    free(adjacency);
+    return 1;
+}
+
+// Breadth-first order following the edges, restarted from the first unvisited vertex
+static int bfs_order(const a_list *graph, int *inverse) {
+    int n = graph->size;
+    int *visited = calloc(n, sizeof(int));
+    if (visited == NULL) return 0;
+    int head = 0;
+    int tail = 0;
+    for (int root = 0; root < n; root++) {
+        if (visited[root]) continue;
+        visited[root] = 1;
+        inverse[tail++] = root;
+        while (head < tail) {
+            int v = inverse[head++];
+            for (cell *c = graph->array[v].head; c != NULL; c = c->next) {
+                int w = c->arr - 1;
+                if (!visited[w]) {
+                    visited[w] = 1;
+                    inverse[tail++] = w;
+                }
+            }
+        }
+    }
+    free(visited);
+    return 1;
+}
+
+// Hubs first: vertices by decreasing in + out degree, ties kept in their original order
+static int degree_order(const a_list *graph, int *inverse) {
+    int n = graph->size;
+    int *degree = calloc(n, sizeof(int));
+    if (degree == NULL) return 0;
+    int max_degree = 0;
+    for (int v = 0; v < n; v++) {
+        for (cell *c = graph->array[v].head; c != NULL; c = c->next) {
+            degree[v]++;
+            degree[c->arr - 1]++;
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        if (degree[v] > max_degree) max_degree = degree[v];
+    }
+    // counting sort on max_degree - degree, which is stable
+    int *count = calloc(max_degree + 2, sizeof(int));
+    if (count == NULL) {
+        free(degree);
+        return 0;
+    }
+    for (int v = 0; v < n; v++) count[max_degree - degree[v] + 1]++;
+    for (int d = 0; d <= max_degree; d++) count[d + 1] += count[d];
+    for (int v = 0; v < n; v++) inverse[count[max_degree - degree[v]]++] = v;
+    free(count);
+    free(degree);
+    return 1;
+}
+
+// Function that computes a locality-improving relabelling of the graph
+t_permutation* locality_permutation(const a_list *graph, t_order_strategy strategy) {
+    if (graph == NULL || graph->array == NULL || graph->size <= 0) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return NULL;
+    }
+    int *inverse = malloc(graph->size * sizeof(int));
+    int done = 0;
+    if (inverse != NULL) {
+        switch (strategy) {
+            case ORDER_RCM:
+                done = rcm_order(graph, inverse);
+                break;
+            case ORDER_BFS:
+                done = bfs_order(graph, inverse);
+                break;
+            case ORDER_DEGREE:
+                done = degree_order(graph, inverse);
+                break;
+        }
+    }
+    if (!done) {
+        fprintf(stderr, "Memory allocation error for permutation (sorry ;()\n");
+        free(inverse);
+        return NULL;
+    }
+    t_permutation *perm = create_permutation(inverse, graph->size);
+    free(inverse);
+    return perm;
+}
+
+// Function that displays a relabelled graph with the original 1-based vertex numbers
+void display_permuted_a_list(const a_list *graph, const t_permutation *perm) {
+    for (int i = 0; i < graph->size; i++) {
+        printf("Vertex %d:", perm->inverse[i] + 1);
+        for (cell *c = graph->array[i].head; c != NULL; c = c->next) {
+            printf(" -> (%d, %.2f)", perm->inverse[c->arr - 1] + 1, c->proba);
+        }
+        printf("\n");
+    }
+}
+
+// Function that builds the relabelled copy of a graph (edges kept sorted by target)
+a_list permute_graph(const a_list *graph, const t_permutation *perm) {
+    a_list *permuted = create_a_list(graph->size);
+    // blocks are allocated in the new order, so that they also follow it in memory
+    for (int i = 0; i < graph->size; i++) {
+        const list *old = &graph->array[perm->inverse[i]];
+        list *l = &permuted->array[i];
+        int degree = 0;
+        for (cell *c = old->head; c != NULL; c = c->next) degree++;
+        if (degree == 0) continue;
+        l->head = malloc(degree * sizeof(cell));
+        if (l->head == NULL) {
+            fprintf(stderr, "Memory allocation error (Never sure how that happens honestly. Unfreed memory? Problem with the engine? Take your guess :p)\n");
+            exit(EXIT_FAILURE);
+        }
+        l->capacity = degree;
+        for (cell *c = old->head; c != NULL; c = c->next) {
+            l->head[l->size].arr = perm->forward[c->arr - 1] + 1;  // cells keep 1-based targets
+            l->head[l->size].proba = c->proba;
+            l->size++;
+        }
+        qsort(l->head, l->size, sizeof(cell), compare_cells);
+        relink_block(l, 0);
+    }
+    a_list result = *permuted;
+    free(permuted);
+    return result;
+}
+
+// Function that builds the relabelled copy of a matrix: result[forward[i]][forward[j]] = m[i][j]
+matrix* permute_matrix(const matrix *m, const t_permutation *perm) {
+    if (m == NULL || perm == NULL || m->size != perm->size) {
+        fprintf(stderr, "Error: Matrix and permutation sizes do not match\n");
+        return NULL;
+    }
+    matrix *result = create_zero_matrix(m->size);
+    if (result == NULL) return NULL;
+    for (int i = 0; i < m->size; i++) {
+        const float *source = m->data[perm->inverse[i]];  // new row i is old row inverse[i]
+        for (int j = 0; j < m->size; j++) {
+            result->data[i][j] = source[perm->inverse[j]];
+        }
+    }
+    return result;
+}
+
+// Function that copies a partition with the vertices renamed by the permutation
+t_partition permute_partition(const t_partition *partition, const t_permutation *perm) {
+    t_partition result;
+    result.size = partition->size;
+    result.capacity = partition->size;
+    result.classes = malloc(partition->size * sizeof(t_class));
+    if (result.classes == NULL && partition->size > 0) {
+        fprintf(stderr, "Memory allocation error (Never sure how that happens honestly. Unfreed memory? Problem with the engine? Take your guess :p)\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int c = 0; c < partition->size; c++) {
+        const t_class *old = &partition->classes[c];
+        t_class *cls = &result.classes[c];
+        cls->name = malloc(strlen(old->name) + 1);
+        cls->vertices = malloc(old->size * sizeof(t_tarjan_vertex));
+        if (cls->name == NULL || (cls->vertices == NULL && old->size > 0)) {
+            fprintf(stderr, "Memory allocation error (Never sure how that happens honestly. Unfreed memory? Problem with the engine? Take your guess :p)\n");
+            exit(EXIT_FAILURE);
+        }
+        strcpy(cls->name, old->name);
+        cls->size = old->size;
+        cls->capacity = old->size;
+        for (int i = 0; i < old->size; i++) {
+            cls->vertices[i] = old->vertices[i];
+            cls->vertices[i].identifier = perm->forward[old->vertices[i].identifier];
+        }
+    }
+    return result;
+}
+
+// Function that moves a vector indexed by old labels to the new labels
+void permute_vector(const float *source, float *destination, const t_permutation *perm) {
+    for (int i = 0; i < perm->size; i++) destination[perm->forward[i]] = source[i];
+}
+
+// Function that brings a vector indexed by new labels back to the old labels
+void unpermute_vector(const float *source, float *destination, const t_permutation *perm) {
+    for (int i = 0; i < perm->size; i++) destination[perm->inverse[i]] = source[i];
+}
@@ -0,0 +1,43 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef PERMUTATION_H
+#define PERMUTATION_H
+#include "functions.h"
+
+// Relabelling of the vertices (0-based on both sides)
+typedef struct {
+    int *forward;   // forward[old] = new label of vertex old
+    int *inverse;   // inverse[new] = old label of vertex new
+    int size;       // Number of vertices
+} t_permutation;
+
+// Strategies of locality_permutation
+typedef enum {
+    ORDER_RCM,      // Reverse Cuthill-McKee on the undirected version of the graph
+    ORDER_BFS,      // Breadth-first order following the edges
+    ORDER_DEGREE    // Hubs first (decreasing in + out degree)
+} t_order_strategy;
+
+t_permutation* create_permutation(const int *, int);
+
+void free_permutation(t_permutation *);
+
+t_permutation* class_order_permutation(t_partition *, int, int *);
+
+a_list permute_graph(const a_list *, const t_permutation *);
+
+matrix* permute_matrix(const matrix *, const t_permutation *);
+
+t_partition permute_partition(const t_partition *, const t_permutation *);
+
+t_permutation* locality_permutation(const a_list *, t_order_strategy);
+
+void display_permuted_a_list(const a_list *, const t_permutation *);
+
+void permute_vector(const float *, float *, const t_permutation *);
+
+void unpermute_vector(const float *, float *, const t_permutation *);
+
+#endif //PERMUTATION_H
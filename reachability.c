@@ -0,0 +1,293 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "reachability.h"
+
+// Reachability index over the graph of classes.
+// Two vertices of the same class always reach each other, so a query only has to know whether
+// the class of the first vertex reaches the class of the second one in the class graph (a DAG).
+// compute_partition lists the classes sinks first, so every class link goes to a lower index and
+// the classes can be processed by increasing index once their successors are done.
+//  - bitsets: row c is the union of the rows of its successors, a query reads one bit;
+//  - intervals: the classes get post-order numbers from a spanning forest, and each class keeps the
+//    merged intervals of post-order numbers it reaches, a query is a binary search among them.
+
+
+// Successor classes of each class, without repetition
+typedef struct {
+    int *offsets;   // Start of the successors of each class (nb_classes + 1 entries)
+    int *targets;   // Successor class indices
+} t_class_successors;
+
+static void reach_alloc_error(void) {
+    fprintf(stderr, "Memory allocation error for reachability index (sorry ;()\n");
+}
+
+// Build the class links from the edges of the graph (two passes: count, then fill)
+static int build_class_successors(a_list *graph, t_partition *partition, const int *vertex_to_class,
+                                  t_class_successors *succ) {
+    int nb_classes = partition->size;
+    int *mark = malloc(nb_classes * sizeof(int));
+    succ->offsets = malloc((nb_classes + 1) * sizeof(int));
+    succ->targets = NULL;
+    if ((nb_classes > 0 && mark == NULL) || succ->offsets == NULL) {
+        free(mark);
+        free(succ->offsets);
+        return 0;
+    }
+    for (int pass = 0; pass < 2; pass++) {
+        for (int c = 0; c < nb_classes; c++) mark[c] = -1;
+        int count = 0;
+        for (int c = 0; c < nb_classes; c++) {
+            if (pass == 0) succ->offsets[c] = count;
+            for (int k = 0; k < partition->classes[c].size; k++) {
+                int v = partition->classes[c].vertices[k].identifier;
+                for (cell *e = graph->array[v].head; e != NULL; e = e->next) {
+                    int d = vertex_to_class[e->arr - 1];
+                    if (d == c || mark[d] == c) continue;
+                    mark[d] = c;
+                    if (pass == 1) succ->targets[count] = d;
+                    count++;
+                }
+            }
+        }
+        if (pass == 0) {
+            succ->offsets[nb_classes] = count;
+            succ->targets = malloc((count > 0 ? count : 1) * sizeof(int));
+            if (succ->targets == NULL) {
+                free(mark);
+                free(succ->offsets);
+                return 0;
+            }
+        }
+    }
+    free(mark);
+    return 1;
+}
+
+static int build_bitsets(t_reach_index *index, const t_class_successors *succ) {
+    int nb_classes = index->nb_classes;
+    index->words = (nb_classes + 63) / 64;
+    index->bits = calloc((size_t)nb_classes * index->words + 1, sizeof(uint64_t));
+    if (index->bits == NULL) return 0;
+    for (int c = 0; c < nb_classes; c++) {
+        uint64_t *row = &index->bits[(size_t)c * index->words];
+        row[c / 64] |= 1ULL << (c % 64);
+        for (int s = succ->offsets[c]; s < succ->offsets[c + 1]; s++) {
+            const uint64_t *other = &index->bits[(size_t)succ->targets[s] * index->words];
+            for (int w = 0; w < index->words; w++) row[w] |= other[w];
+        }
+    }
+    return 1;
+}
+
+static int compare_intervals(const void *a, const void *b) {
+    const int *x = a;
+    const int *y = b;
+    return (x[0] > y[0]) - (x[0] < y[0]);
+}
+
+static int build_intervals(t_reach_index *index, const t_class_successors *succ) {
+    int nb_classes = index->nb_classes;
+    int *first = malloc((nb_classes + 1) * sizeof(int));      // smallest post-order number of each subtree
+    int *has_parent = calloc(nb_classes + 1, sizeof(int));
+    int *stack = malloc((nb_classes + 1) * sizeof(int));
+    int *next_edge = malloc((nb_classes + 1) * sizeof(int));
+    index->post = malloc((nb_classes + 1) * sizeof(int));
+    index->interval_offsets = malloc((nb_classes + 1) * sizeof(int));
+    int capacity = 2 * nb_classes + 2;
+    index->intervals = malloc(capacity * sizeof(int));
+    int *buffer = NULL;
+    int buffer_capacity = 0;
+    int ok = first != NULL && has_parent != NULL && stack != NULL && next_edge != NULL &&
+             index->post != NULL && index->interval_offsets != NULL && index->intervals != NULL;
+    if (ok) {
+        index->interval_offsets[0] = 0;
+        // spanning forest: depth-first from every class without predecessor, post-order numbering
+        for (int s = 0; s < succ->offsets[nb_classes]; s++) has_parent[succ->targets[s]] = 1;
+        for (int c = 0; c < nb_classes; c++) index->post[c] = -1;
+        int counter = 0;
+        for (int root = nb_classes - 1; root >= 0; root--) {
+            if (has_parent[root] || index->post[root] >= 0) continue;
+            int top = 0;
+            stack[top++] = root;
+            first[root] = counter;
+            next_edge[root] = succ->offsets[root];
+            index->post[root] = -2;  // on the current path
+            while (top > 0) {
+                int c = stack[top - 1];
+                if (next_edge[c] < succ->offsets[c + 1]) {
+                    int d = succ->targets[next_edge[c]++];
+                    if (index->post[d] != -1) continue;
+                    index->post[d] = -2;
+                    first[d] = counter;
+                    next_edge[d] = succ->offsets[d];
+                    stack[top++] = d;
+                } else {
+                    index->post[c] = counter++;
+                    top--;
+                }
+            }
+        }
+        // intervals of each class: its own subtree, merged with the intervals of its successors
+        int size = 0;
+        for (int c = 0; c < nb_classes && ok; c++) {
+            int needed = 2;
+            for (int s = succ->offsets[c]; s < succ->offsets[c + 1]; s++) {
+                int d = succ->targets[s];
+                needed += index->interval_offsets[d + 1] - index->interval_offsets[d];
+            }
+            if (needed > buffer_capacity) {
+                int *grown = realloc(buffer, needed * sizeof(int));
+                if (grown == NULL) {
+                    ok = 0;
+                    break;
+                }
+                buffer = grown;
+                buffer_capacity = needed;
+            }
+            int length = 0;
+            buffer[length++] = first[c];
+            buffer[length++] = index->post[c];
+            for (int s = succ->offsets[c]; s < succ->offsets[c + 1]; s++) {
+                int d = succ->targets[s];
+                for (int i = index->interval_offsets[d]; i < index->interval_offsets[d + 1]; i++) {
+                    buffer[length++] = index->intervals[i];
+                }
+            }
+            qsort(buffer, length / 2, 2 * sizeof(int), compare_intervals);
+            if (size + length > capacity) {
+                while (size + length > capacity) capacity *= 2;
+                int *grown = realloc(index->intervals, capacity * sizeof(int));
+                if (grown == NULL) {
+                    ok = 0;
+                    break;
+                }
+                index->intervals = grown;
+            }
+            index->interval_offsets[c] = size;
+            for (int i = 0; i < length; i += 2) {
+                // intervals that overlap or touch are joined
+                if (size > index->interval_offsets[c] && buffer[i] <= index->intervals[size - 1] + 1) {
+                    if (buffer[i + 1] > index->intervals[size - 1]) index->intervals[size - 1] = buffer[i + 1];
+                } else {
+                    index->intervals[size++] = buffer[i];
+                    index->intervals[size++] = buffer[i + 1];
+                }
+            }
+            index->interval_offsets[c + 1] = size;
+        }
+        if (ok && size > 0) {
+            int *shrunk = realloc(index->intervals, size * sizeof(int));
+            if (shrunk != NULL) index->intervals = shrunk;
+        }
+    }
+    free(first);
+    free(has_parent);
+    free(stack);
+    free(next_edge);
+    free(buffer);
+    return ok;
+}
+
+// Function that builds the reachability index of a graph from its partition
+t_reach_index* create_reach_index(a_list *graph, t_partition *partition, t_reach_method method) {
+    if (graph == NULL || graph->array == NULL || partition == NULL) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return NULL;
+    }
+    t_reach_index *index = calloc(1, sizeof(t_reach_index));
+    if (index == NULL) {
+        reach_alloc_error();
+        return NULL;
+    }
+    index->nb_vertices = graph->size;
+    index->nb_classes = partition->size;
+    index->vertex_to_class = create_vertex_to_class(partition, graph->size);
+    if (index->vertex_to_class == NULL) {
+        free(index);
+        return NULL;
+    }
+    t_class_successors succ;
+    if (!build_class_successors(graph, partition, index->vertex_to_class, &succ)) {
+        reach_alloc_error();
+        free_reach_index(index);
+        return NULL;
+    }
+    if (method == REACH_AUTO) {
+        size_t bitset_bytes = (size_t)index->nb_classes * ((index->nb_classes + 63) / 64) * sizeof(uint64_t);
+        method = (bitset_bytes <= REACH_BITSET_LIMIT) ? REACH_BITSET : REACH_INTERVALS;
+    }
+    index->method = method;
+    int ok = (method == REACH_BITSET) ? build_bitsets(index, &succ) : build_intervals(index, &succ);
+    free(succ.offsets);
+    free(succ.targets);
+    if (!ok) {
+        reach_alloc_error();
+        free_reach_index(index);
+        return NULL;
+    }
+    return index;
+}
+
+// Function that frees a reachability index
+void free_reach_index(t_reach_index *index) {
+    if (index == NULL) return;
+    free(index->vertex_to_class);
+    free(index->bits);
+    free(index->post);
+    free(index->interval_offsets);
+    free(index->intervals);
+    free(index);
+}
+
+static int class_reaches(const t_reach_index *index, int c, int d) {
+    if (c == d) return 1;
+    if (index->method == REACH_BITSET) {
+        return (int)((index->bits[(size_t)c * index->words + d / 64] >> (d % 64)) & 1);
+    }
+    // last interval starting at or before post[d], then check that it also ends after it
+    int p = index->post[d];
+    int low = index->interval_offsets[c] / 2;
+    int high = index->interval_offsets[c + 1] / 2 - 1;
+    while (low < high) {
+        int mid = (low + high + 1) / 2;
+        if (index->intervals[2 * mid] <= p) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+    return low <= high && index->intervals[2 * low] <= p && p <= index->intervals[2 * low + 1];
+}
+
+// Function that tells whether vertex "from" can reach vertex "to" (1 if it can, 0 if not, -1 on invalid input)
+int reach_query(const t_reach_index *index, int from, int to) {
+    if (index == NULL || from < 1 || from > index->nb_vertices || to < 1 || to > index->nb_vertices) {
+        return -1;
+    }
+    return class_reaches(index, index->vertex_to_class[from - 1], index->vertex_to_class[to - 1]);
+}
+
+// Function that answers nb queries at once: answers[q] = reach_query(index, from[q], to[q])
+void reach_query_batch(const t_reach_index *index, const int *from, const int *to, int nb, int *answers) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if(nb > 4096)
+#endif
+    for (int q = 0; q < nb; q++) {
+        answers[q] = reach_query(index, from[q], to[q]);
+    }
+}
+
+// Function that gives the memory used by a reachability index, in bytes
+size_t reach_index_memory(const t_reach_index *index) {
+    size_t bytes = sizeof(t_reach_index) + index->nb_vertices * sizeof(int);
+    if (index->method == REACH_BITSET) {
+        bytes += (size_t)index->nb_classes * index->words * sizeof(uint64_t);
+    } else {
+        bytes += 2 * ((size_t)index->nb_classes + 1) * sizeof(int);
+        bytes += (size_t)index->interval_offsets[index->nb_classes] * sizeof(int);
+    }
+    return bytes;
+}
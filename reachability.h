@@ -0,0 +1,44 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef REACHABILITY_H
+#define REACHABILITY_H
+#include <stdint.h>
+#include "functions.h"
+
+// Labelling used by a reachability index
+typedef enum {
+    REACH_AUTO,         // Bitsets when they fit in REACH_BITSET_LIMIT bytes, intervals otherwise
+    REACH_BITSET,       // Full transitive closure of the class graph, one bit per pair of classes
+    REACH_INTERVALS     // Post-order intervals of a spanning forest, merged along the class links
+} t_reach_method;
+
+// Largest transitive closure (in bytes) that REACH_AUTO stores as bitsets
+#define REACH_BITSET_LIMIT (64u << 20)
+
+// Answers "can vertex i reach vertex j?" without searching the graph
+typedef struct {
+    int nb_vertices;            // Number of vertices
+    int nb_classes;             // Number of classes of the partition
+    int *vertex_to_class;       // Class index of each vertex (0-based)
+    t_reach_method method;      // Labelling actually built (never REACH_AUTO)
+    int words;                  // Number of 64-bit words of each bitset row
+    uint64_t *bits;             // Bitset rows: bit d of row c is set when class c reaches class d
+    int *post;                  // Post-order number of each class in the spanning forest
+    int *interval_offsets;      // Start of the intervals of each class (nb_classes + 1 entries)
+    int *intervals;             // Sorted disjoint intervals [low, high] of post-order numbers, two ints each
+} t_reach_index;
+
+t_reach_index* create_reach_index(a_list *, t_partition *, t_reach_method);
+
+void free_reach_index(t_reach_index *);
+
+// Queries use the 1-based vertex numbers of the input file; a vertex always reaches itself
+int reach_query(const t_reach_index *, int, int);
+
+void reach_query_batch(const t_reach_index *, const int *, const int *, int, int *);
+
+size_t reach_index_memory(const t_reach_index *);
+
+#endif //REACHABILITY_H
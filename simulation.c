@@ -0,0 +1,301 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "simulation.h"
+#include <stdint.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Monte Carlo random walks on the loaded graph.
+// Each step draws its next vertex from the Walker alias table of the current vertex in O(1).
+// The random numbers are counter-based: the value used at step t of walk w only depends on
+// (seed, w, t), so the results are the same whatever the number of threads.
+
+
+// SplitMix64 finaliser, used as the counter-based generator
+static uint64_t mix64(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Random value number counter of the stream of one walk
+static uint64_t stream_value(uint64_t key, uint64_t counter) {
+    return mix64(key + counter * 0xD1B54A32D192ED03ULL);
+}
+
+// Function that builds the alias table of every vertex (Vose's method)
+// Probabilities are normalised by their sum, so rows that do not sum exactly to 1 are accepted
+t_alias_table* create_alias_table(a_list *graph) {
+    if (graph == NULL || graph->array == NULL) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return NULL;
+    }
+    t_alias_table *table = malloc(sizeof(t_alias_table));
+    if (table == NULL) {
+        fprintf(stderr, "Memory allocation error for alias table (sorry ;()\n");
+        return NULL;
+    }
+    int n = graph->size;
+    table->size = n;
+    table->offsets = malloc((n + 1) * sizeof(int));
+    if (table->offsets == NULL) {
+        fprintf(stderr, "Memory allocation error for alias table (sorry ;()\n");
+        free(table);
+        return NULL;
+    }
+    table->offsets[0] = 0;
+    int max_degree = 0;
+    for (int v = 0; v < n; v++) {
+        int degree = 0;
+        for (cell *c = graph->array[v].head; c != NULL; c = c->next) degree++;
+        table->offsets[v + 1] = table->offsets[v] + degree;
+        if (degree > max_degree) max_degree = degree;
+    }
+    int nb_columns = table->offsets[n];
+    table->targets = malloc(nb_columns * sizeof(int));
+    table->alias = malloc(nb_columns * sizeof(int));
+    table->threshold = malloc(nb_columns * sizeof(float));
+    double *scaled = malloc(max_degree * sizeof(double));
+    int *small = malloc(max_degree * sizeof(int));
+    int *large = malloc(max_degree * sizeof(int));
+    if ((nb_columns > 0 && (table->targets == NULL || table->alias == NULL || table->threshold == NULL)) ||
+        (max_degree > 0 && (scaled == NULL || small == NULL || large == NULL))) {
+        fprintf(stderr, "Memory allocation error for alias table (sorry ;()\n");
+        free(scaled);
+        free(small);
+        free(large);
+        free_alias_table(table);
+        return NULL;
+    }
+    for (int v = 0; v < n; v++) {
+        int base = table->offsets[v];
+        int degree = table->offsets[v + 1] - base;
+        if (degree == 0) continue;
+        double total = 0;
+        int k = 0;
+        for (cell *c = graph->array[v].head; c != NULL; c = c->next) {
+            double p = (c->proba > 0) ? c->proba : 0;
+            scaled[k] = p;
+            table->targets[base + k] = c->arr - 1;
+            total += p;
+            k++;
+        }
+        int nb_small = 0;
+        int nb_large = 0;
+        for (k = 0; k < degree; k++) {
+            // scale so that the average column holds exactly 1
+            scaled[k] = (total > 0) ? scaled[k] * degree / total : 1.0;
+            if (scaled[k] < 1.0) {
+                small[nb_small++] = k;
+            } else {
+                large[nb_large++] = k;
+            }
+        }
+        // each small column is topped up by a large one, which becomes its alias
+        while (nb_small > 0 && nb_large > 0) {
+            int s = small[--nb_small];
+            int l = large[nb_large - 1];
+            table->threshold[base + s] = (float)scaled[s];
+            table->alias[base + s] = table->targets[base + l];
+            scaled[l] -= 1.0 - scaled[s];
+            if (scaled[l] < 1.0) {
+                nb_large--;
+                small[nb_small++] = l;
+            }
+        }
+        // what is left is full up to rounding errors
+        while (nb_large > 0) {
+            int l = large[--nb_large];
+            table->threshold[base + l] = 1.0f;
+            table->alias[base + l] = table->targets[base + l];
+        }
+        while (nb_small > 0) {
+            int s = small[--nb_small];
+            table->threshold[base + s] = 1.0f;
+            table->alias[base + s] = table->targets[base + s];
+        }
+    }
+    free(scaled);
+    free(small);
+    free(large);
+    return table;
+}
+
+// Function that frees an alias table
+void free_alias_table(t_alias_table *table) {
+    if (table == NULL) return;
+    free(table->offsets);
+    free(table->targets);
+    free(table->alias);
+    free(table->threshold);
+    free(table);
+}
+
+// Draw the successor of vertex v (a vertex without outgoing edges keeps the walk where it is)
+static int alias_step(const t_alias_table *table, int v, uint64_t random) {
+    int base = table->offsets[v];
+    int degree = table->offsets[v + 1] - base;
+    if (degree == 0) return v;
+    // high 32 bits pick the column, low 32 bits are the coin
+    int column = (int)(((random >> 32) * (uint64_t)degree) >> 32);
+    float coin = (float)(random & 0xFFFFFFFFULL) * (1.0f / 4294967296.0f);
+    return (coin < table->threshold[base + column]) ? table->targets[base + column] : table->alias[base + column];
+}
+
+// Function that simulates independent walks from a start vertex and gathers visit frequencies,
+// hitting times of the target and the persistent class where each walk was absorbed
+t_simulation_result* simulate_walks(a_list *graph, t_partition *partition, const t_simulation_options *options) {
+    if (graph == NULL || partition == NULL || options == NULL) {
+        fprintf(stderr, "Error: Invalid simulation input (sorry ;()\n");
+        return NULL;
+    }
+    int n = graph->size;
+    if (options->start < 1 || options->start > n || options->target < 0 || options->target > n) {
+        fprintf(stderr, "Error: Invalid start or target vertex for the simulation\n");
+        return NULL;
+    }
+    t_alias_table *table = create_alias_table(graph);
+    int *vertex_to_class = create_vertex_to_class(partition, n);
+    int *persistent = malloc(partition->size * sizeof(int));
+    t_simulation_result *result = calloc(1, sizeof(t_simulation_result));
+    if (table == NULL || vertex_to_class == NULL || persistent == NULL || result == NULL) {
+        fprintf(stderr, "Memory allocation error for simulation (sorry ;()\n");
+        free_alias_table(table);
+        free(vertex_to_class);
+        free(persistent);
+        free(result);
+        return NULL;
+    }
+    result->size = n;
+    result->nb_classes = partition->size;
+    result->visits = calloc(n, sizeof(long long));
+    result->visit_frequency = calloc(n, sizeof(double));
+    result->absorbed = calloc(partition->size, sizeof(int));
+    if (result->visits == NULL || result->visit_frequency == NULL || result->absorbed == NULL) {
+        fprintf(stderr, "Memory allocation error for simulation (sorry ;()\n");
+        free_alias_table(table);
+        free(vertex_to_class);
+        free(persistent);
+        free_simulation_result(result);
+        return NULL;
+    }
+    // a class is persistent when none of its edges leaves it
+    for (int c = 0; c < partition->size; c++) persistent[c] = 1;
+    for (int v = 0; v < n; v++) {
+        for (cell *c = graph->array[v].head; c != NULL; c = c->next) {
+            if (vertex_to_class[c->arr - 1] != vertex_to_class[v]) persistent[vertex_to_class[v]] = 0;
+        }
+    }
+    int start = options->start - 1;
+    int target = options->target - 1;
+    long long total_hitting = 0;
+    int nb_hits = 0;
+    int nb_unabsorbed = 0;
+    int failed = 0;
+#ifdef _OPENMP
+    int nb_threads = (options->nb_threads > 0) ? options->nb_threads : omp_get_max_threads();
+#pragma omp parallel num_threads(nb_threads) reduction(+:total_hitting, nb_hits, nb_unabsorbed)
+#endif
+    {
+        // each thread counts in its own arrays, merged once at the end
+        long long *visits = calloc(n, sizeof(long long));
+        int *absorbed = calloc(partition->size, sizeof(int));
+        int thread_failed = (visits == NULL || absorbed == NULL);
+        if (thread_failed) {
+#ifdef _OPENMP
+#pragma omp atomic write
+#endif
+            failed = 1;
+        }
+        // every thread reaches the loop, a thread without arrays skips its walks
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (int w = 0; w < options->nb_walks; w++) {
+            if (thread_failed) continue;
+            uint64_t key = mix64(options->seed ^ mix64((uint64_t)w));
+            int v = start;
+            int hit = (v == target) ? 0 : -1;
+            int absorbed_in = persistent[vertex_to_class[v]] ? vertex_to_class[v] : -1;
+            visits[v]++;
+            for (int t = 1; t <= options->max_steps; t++) {
+                v = alias_step(table, v, stream_value(key, (uint64_t)t));
+                visits[v]++;
+                if (hit < 0 && v == target) hit = t;
+                if (absorbed_in < 0 && persistent[vertex_to_class[v]]) absorbed_in = vertex_to_class[v];
+            }
+            if (hit >= 0) {
+                total_hitting += hit;
+                nb_hits++;
+            }
+            if (absorbed_in >= 0) {
+                absorbed[absorbed_in]++;
+            } else {
+                nb_unabsorbed++;
+            }
+        }
+        if (!thread_failed) {
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+            {
+                for (int v = 0; v < n; v++) result->visits[v] += visits[v];
+                for (int c = 0; c < partition->size; c++) result->absorbed[c] += absorbed[c];
+            }
+        }
+        free(visits);
+        free(absorbed);
+    }
+    free_alias_table(table);
+    free(vertex_to_class);
+    free(persistent);
+    if (failed) {
+        fprintf(stderr, "Memory allocation error for simulation (sorry ;()\n");
+        free_simulation_result(result);
+        return NULL;
+    }
+    long long total_visits = (long long)options->nb_walks * (options->max_steps + 1);
+    for (int v = 0; v < n; v++) {
+        result->visit_frequency[v] = (total_visits > 0) ? (double)result->visits[v] / total_visits : 0;
+    }
+    result->nb_hits = nb_hits;
+    result->mean_hitting_time = (nb_hits > 0) ? (double)total_hitting / nb_hits : -1;
+    result->nb_unabsorbed = nb_unabsorbed;
+    return result;
+}
+
+// Function that displays the results of a simulation
+void display_simulation_result(const t_simulation_result *result, t_partition *partition) {
+    printf("Visit frequencies:\n");
+    for (int v = 0; v < result->size; v++) {
+        printf("  State %d: %.4f\n", v + 1, result->visit_frequency[v]);
+    }
+    if (result->nb_hits > 0) {
+        printf("Target reached by %d walk(s), mean hitting time %.2f steps\n",
+               result->nb_hits, result->mean_hitting_time);
+    } else {
+        printf("Target never reached\n");
+    }
+    printf("Absorption:\n");
+    for (int c = 0; c < result->nb_classes; c++) {
+        if (result->absorbed[c] > 0) {
+            printf("  Class %s: %d walk(s)\n", partition->classes[c].name, result->absorbed[c]);
+        }
+    }
+    if (result->nb_unabsorbed > 0) {
+        printf("  Still transient: %d walk(s)\n", result->nb_unabsorbed);
+    }
+}
+
+// Function that frees the results of a simulation
+void free_simulation_result(t_simulation_result *result) {
+    if (result == NULL) return;
+    free(result->visits);
+    free(result->visit_frequency);
+    free(result->absorbed);
+    free(result);
+}
@@ -0,0 +1,50 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef SIMULATION_H
+#define SIMULATION_H
+#include "functions.h"
+
+// Walker alias tables of all the vertices, stored one after the other
+typedef struct {
+    int *offsets;       // Start of the columns of each vertex (size + 1 entries)
+    int *targets;       // Vertex (0-based) kept by each column
+    int *alias;         // Vertex (0-based) taken instead when the coin is above the threshold
+    float *threshold;   // Probability of keeping the column's own target
+    int size;           // Number of vertices
+} t_alias_table;
+
+// Parameters of a simulation
+typedef struct {
+    int nb_walks;               // Number of independent walks
+    int max_steps;              // Length of each walk
+    int start;                  // Start vertex (1-based)
+    int target;                 // Vertex whose hitting time is measured (1-based, 0 for none)
+    unsigned long long seed;    // Seed of the random streams (same seed = same results)
+    int nb_threads;             // Number of threads (0 lets OpenMP decide)
+} t_simulation_options;
+
+// Results of a simulation
+typedef struct {
+    int size;                   // Number of vertices
+    int nb_classes;             // Number of classes of the partition
+    long long *visits;          // Number of steps spent at each vertex, over all walks
+    double *visit_frequency;    // Fraction of all the steps spent at each vertex
+    int nb_hits;                // Number of walks that reached the target
+    double mean_hitting_time;   // Mean number of steps to reach the target (over the walks that did)
+    int *absorbed;              // Number of walks absorbed by each persistent class
+    int nb_unabsorbed;          // Number of walks still in a transient class at the end
+} t_simulation_result;
+
+t_alias_table* create_alias_table(a_list *);
+
+void free_alias_table(t_alias_table *);
+
+t_simulation_result* simulate_walks(a_list *, t_partition *, const t_simulation_options *);
+
+void display_simulation_result(const t_simulation_result *, t_partition *);
+
+void free_simulation_result(t_simulation_result *);
+
+#endif //SIMULATION_H
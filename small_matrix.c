@@ -0,0 +1,89 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "small_matrix.h"
+
+// Matrix product kernels specialised at compile time for 4, 8, 16 and 32 states.
+// The size being a constant, the compiler unrolls the loops and vectorises each row update
+// c[i][.] += a[i][k] * b[k][.]; the terms of every entry are added in the same order (k increasing)
+// as in the generic product, so the results are identical. Smaller sizes are padded with zeros.
+
+
+#if defined(__GNUC__) && !defined(__clang__)
+#define SMALL_UNROLL _Pragma("GCC unroll 32")
+#else
+#define SMALL_UNROLL
+#endif
+
+#define DEFINE_SMALL_KERNEL(N) \
+static void multiply_##N(const float *restrict a, const float *restrict b, float *restrict c) { \
+    for (int i = 0; i < N; i++) { \
+        _Alignas(64) float row[N] = {0}; \
+        SMALL_UNROLL \
+        for (int k = 0; k < N; k++) { \
+            float a_ik = a[i * N + k]; \
+            for (int j = 0; j < N; j++) row[j] += a_ik * b[k * N + j]; \
+        } \
+        for (int j = 0; j < N; j++) c[i * N + j] = row[j]; \
+    } \
+}
+
+DEFINE_SMALL_KERNEL(4)
+DEFINE_SMALL_KERNEL(8)
+DEFINE_SMALL_KERNEL(16)
+DEFINE_SMALL_KERNEL(32)
+
+// Function that gives the kernel size used for a matrix of the given size (0 if it is too large)
+int small_kernel_size(int size) {
+    if (size <= 0 || size > SMALL_MATRIX_MAX) return 0;
+    if (size <= 4) return 4;
+    if (size <= 8) return 8;
+    if (size <= 16) return 16;
+    return 32;
+}
+
+// Function that copies a matrix into the padded in-place layout (returns 0 if it is too large)
+int small_matrix_load(t_small_matrix *small, const matrix *m) {
+    int stride = small_kernel_size(m->size);
+    if (stride == 0) return 0;
+    small->size = m->size;
+    small->stride = stride;
+    memset(small->data, 0, stride * stride * sizeof(float));
+    for (int i = 0; i < m->size; i++) {
+        memcpy(&small->data[i * stride], m->data[i], m->size * sizeof(float));
+    }
+    return 1;
+}
+
+// Function that copies a small matrix back into a matrix of the same size
+void small_matrix_store(const t_small_matrix *small, matrix *m) {
+    for (int i = 0; i < small->size; i++) {
+        memcpy(m->data[i], &small->data[i * small->stride], small->size * sizeof(float));
+    }
+}
+
+// Function that computes c = a * b with the kernel of their size (c may not be a or b)
+int small_matrix_multiply(const t_small_matrix *a, const t_small_matrix *b, t_small_matrix *c) {
+    if (a->size != b->size || a->stride != b->stride) {
+        fprintf(stderr, "Error: Matrices must be of the same size for multiplication\n");
+        return 0;
+    }
+    c->size = a->size;
+    c->stride = a->stride;
+    switch (a->stride) {
+        case 4:
+            multiply_4(a->data, b->data, c->data);
+            break;
+        case 8:
+            multiply_8(a->data, b->data, c->data);
+            break;
+        case 16:
+            multiply_16(a->data, b->data, c->data);
+            break;
+        default:
+            multiply_32(a->data, b->data, c->data);
+            break;
+    }
+    return 1;
+}
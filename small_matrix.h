@@ -0,0 +1,28 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef SMALL_MATRIX_H
+#define SMALL_MATRIX_H
+#include "functions.h"
+
+// Largest size handled by the specialised kernels
+#define SMALL_MATRIX_MAX 32
+
+// Matrix of at most 32 x 32 stored in place (no heap allocation), rows padded with zeros to the
+// kernel size (4, 8, 16 or 32) so that every row is one aligned run of floats
+typedef struct {
+    _Alignas(64) float data[SMALL_MATRIX_MAX * SMALL_MATRIX_MAX];
+    int size;       // Number of states
+    int stride;     // Kernel size used (row length in data)
+} t_small_matrix;
+
+int small_kernel_size(int);
+
+int small_matrix_load(t_small_matrix *, const matrix *);
+
+void small_matrix_store(const t_small_matrix *, matrix *);
+
+int small_matrix_multiply(const t_small_matrix *, const t_small_matrix *, t_small_matrix *);
+
+#endif //SMALL_MATRIX_H
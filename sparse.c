@@ -0,0 +1,428 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "sparse.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Sparse matrices in CSR form, taken from the graph, and their product by Gustavson's algorithm:
+// row i of AB is the sum of the rows k of B weighted by A(i,k), gathered in an accumulator.
+// The number of products of a row bounds its number of entries: when that bound is small, the row
+// is accumulated in a small open-addressing hash table that stays in cache; otherwise it goes into
+// a dense accumulator indexed by column, with the list of the columns touched so that clearing it
+// only costs the entries of the row (random columns of a large dense array miss the cache on
+// almost every update, which makes the hash table several times faster on short rows).
+// Rows are independent: each thread takes a contiguous range of rows with its own accumulators and
+// its own output buffer, and the buffers joined in thread order give the rows in order.
+// Entries smaller than the threshold are dropped (0 keeps everything), which keeps the powers of a
+// chain sparse when they spread into many tiny probabilities.
+
+
+static void sparse_alloc_error(void) {
+    fprintf(stderr, "Memory allocation error for sparse matrix (sorry ;()\n");
+}
+
+static t_sparse_matrix* create_sparse_matrix(int size, int nb_entries) {
+    t_sparse_matrix *sparse = calloc(1, sizeof(t_sparse_matrix));
+    if (sparse == NULL) return NULL;
+    sparse->size = size;
+    sparse->nb_entries = nb_entries;
+    sparse->row_start = calloc(size + 1, sizeof(int));
+    sparse->columns = malloc((nb_entries > 0 ? nb_entries : 1) * sizeof(int));
+    sparse->values = malloc((nb_entries > 0 ? nb_entries : 1) * sizeof(float));
+    if (sparse->row_start == NULL || sparse->columns == NULL || sparse->values == NULL) {
+        free_sparse_matrix(sparse);
+        return NULL;
+    }
+    return sparse;
+}
+
+// Function that builds the sparse transition matrix of a graph
+t_sparse_matrix* sparse_from_graph(const a_list *graph) {
+    if (graph == NULL || graph->array == NULL) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return NULL;
+    }
+    int nb_entries = 0;
+    for (int v = 0; v < graph->size; v++) nb_entries += graph->array[v].size;
+    t_sparse_matrix *sparse = create_sparse_matrix(graph->size, nb_entries);
+    if (sparse == NULL) {
+        sparse_alloc_error();
+        return NULL;
+    }
+    int k = 0;
+    for (int v = 0; v < graph->size; v++) {
+        sparse->row_start[v] = k;
+        for (cell *e = graph->array[v].head; e != NULL; e = e->next) {
+            // lists are kept sorted by target, insertion sort for the rest
+            int position = k++;
+            while (position > sparse->row_start[v] && sparse->columns[position - 1] > e->arr - 1) {
+                sparse->columns[position] = sparse->columns[position - 1];
+                sparse->values[position] = sparse->values[position - 1];
+                position--;
+            }
+            sparse->columns[position] = e->arr - 1;
+            sparse->values[position] = e->proba;
+        }
+    }
+    sparse->row_start[graph->size] = k;
+    return sparse;
+}
+
+#define SPARSE_HASH_LIMIT 8192  // Largest hash table (slots), about 100 KB with its values
+
+// One entry of a row being built
+typedef struct {
+    int column;
+    double value;
+} t_row_entry;
+
+// Accumulators of one thread
+typedef struct {
+    double *dense;          // Value of each column (size entries)
+    char *used;             // 1 for the columns touched by the current row
+    int *hash_keys;         // Columns of the hash table (-1 for an empty slot)
+    double *hash_values;    // Values of the hash table
+    int *touched;           // Columns (dense) or slots (hash) touched by the current row
+    t_row_entry *entries;   // Entries of the current row, sorted by column at the end
+} t_accumulator;
+
+// Sort of the entries of a row by column (quicksort down to short ranges, then insertion sort),
+// without the call per comparison of qsort: rows of products have thousands of entries
+static void sort_entries(t_row_entry *entries, int size) {
+    while (size > 16) {
+        int pivot = entries[size / 2].column;
+        int i = 0;
+        int j = size - 1;
+        while (i <= j) {
+            while (entries[i].column < pivot) i++;
+            while (entries[j].column > pivot) j--;
+            if (i <= j) {
+                t_row_entry swap = entries[i];
+                entries[i++] = entries[j];
+                entries[j--] = swap;
+            }
+        }
+        // recursion on the smaller side keeps the stack short
+        if (j + 1 < size - i) {
+            sort_entries(entries, j + 1);
+            entries += i;
+            size -= i;
+        } else {
+            sort_entries(entries + i, size - i);
+            size = j + 1;
+        }
+    }
+    for (int i = 1; i < size; i++) {
+        t_row_entry entry = entries[i];
+        int j = i;
+        while (j > 0 && entries[j - 1].column > entry.column) {
+            entries[j] = entries[j - 1];
+            j--;
+        }
+        entries[j] = entry;
+    }
+}
+
+// Output of one thread: the entries of its rows, one after the other
+typedef struct {
+    int *columns;
+    float *values;
+    int size;
+    int capacity;
+    int failed;
+} t_row_buffer;
+
+static int reserve_entries(t_row_buffer *buffer, int extra) {
+    if (buffer->size + extra <= buffer->capacity) return 1;
+    int capacity = (buffer->capacity > 0) ? buffer->capacity : 1024;
+    while (capacity < buffer->size + extra) capacity *= 2;
+    int *columns = realloc(buffer->columns, capacity * sizeof(int));
+    if (columns != NULL) buffer->columns = columns;
+    float *values = realloc(buffer->values, capacity * sizeof(float));
+    if (values != NULL) buffer->values = values;
+    if (columns == NULL || values == NULL) {
+        buffer->failed = 1;
+        return 0;
+    }
+    buffer->capacity = capacity;
+    return 1;
+}
+
+static int below_threshold(double value, float threshold) {
+    return threshold > 0 && (float)(value < 0 ? -value : value) < threshold;
+}
+
+// Row i of ab into acc->entries (sorted by column, without the entries below threshold),
+// returns its number of entries
+static int accumulate_row(const t_sparse_matrix *a, const t_sparse_matrix *b, int i, float threshold,
+                          t_accumulator *acc) {
+    long bound = 0;
+    for (int p = a->row_start[i]; p < a->row_start[i + 1]; p++) {
+        int k = a->columns[p];
+        bound += b->row_start[k + 1] - b->row_start[k];
+    }
+    int nb_touched = 0;
+    int slots = 16;
+    while (slots < 2 * bound && slots < SPARSE_HASH_LIMIT) slots *= 2;
+    if (2 * bound <= slots && slots < a->size) {
+        // short row: hash table of a power of two slots, at most half full
+        int mask = slots - 1;
+        for (int p = a->row_start[i]; p < a->row_start[i + 1]; p++) {
+            int k = a->columns[p];
+            double weight = a->values[p];
+            for (int q = b->row_start[k]; q < b->row_start[k + 1]; q++) {
+                int j = b->columns[q];
+                int slot = (int)(((unsigned)j * 2654435761u) & (unsigned)mask);
+                while (acc->hash_keys[slot] != -1 && acc->hash_keys[slot] != j) slot = (slot + 1) & mask;
+                if (acc->hash_keys[slot] == -1) {
+                    acc->hash_keys[slot] = j;
+                    acc->hash_values[slot] = 0;
+                    acc->touched[nb_touched++] = slot;
+                }
+                acc->hash_values[slot] += weight * b->values[q];
+            }
+        }
+        // move the entries out and empty the table
+        int nb_kept = 0;
+        for (int t = 0; t < nb_touched; t++) {
+            int slot = acc->touched[t];
+            acc->entries[nb_kept].column = acc->hash_keys[slot];
+            acc->entries[nb_kept].value = acc->hash_values[slot];
+            acc->hash_keys[slot] = -1;
+            nb_kept += !below_threshold(acc->entries[nb_kept].value, threshold);
+        }
+        nb_touched = nb_kept;
+    } else {
+        for (int p = a->row_start[i]; p < a->row_start[i + 1]; p++) {
+            int k = a->columns[p];
+            double weight = a->values[p];
+            for (int q = b->row_start[k]; q < b->row_start[k + 1]; q++) {
+                int j = b->columns[q];
+                if (!acc->used[j]) {
+                    acc->used[j] = 1;
+                    acc->dense[j] = 0;
+                    acc->touched[nb_touched++] = j;
+                }
+                acc->dense[j] += weight * b->values[q];
+            }
+        }
+        int nb_kept = 0;
+        for (int t = 0; t < nb_touched; t++) {
+            int j = acc->touched[t];
+            acc->entries[nb_kept].column = j;
+            acc->entries[nb_kept].value = acc->dense[j];
+            acc->used[j] = 0;
+            nb_kept += !below_threshold(acc->dense[j], threshold);
+        }
+        nb_touched = nb_kept;
+    }
+    sort_entries(acc->entries, nb_touched);
+    return nb_touched;
+}
+
+// Function that multiplies two sparse matrices, dropping the entries below threshold
+t_sparse_matrix* sparse_multiply(const t_sparse_matrix *a, const t_sparse_matrix *b, float threshold) {
+    if (a == NULL || b == NULL || a->size != b->size) {
+        fprintf(stderr, "Error: Matrices must be the same size to be multiplied\n");
+        return NULL;
+    }
+    int n = a->size;
+    int nb_threads = 1;
+#ifdef _OPENMP
+    nb_threads = omp_get_max_threads();
+#endif
+    t_row_buffer *buffers = calloc(nb_threads, sizeof(t_row_buffer));
+    int *row_size = malloc((n > 0 ? n : 1) * sizeof(int));
+    if (buffers == NULL || row_size == NULL) {
+        sparse_alloc_error();
+        free(buffers);
+        free(row_size);
+        return NULL;
+    }
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nb_threads)
+#endif
+    {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#endif
+        t_row_buffer *buffer = &buffers[thread];
+        t_accumulator acc;
+        acc.dense = calloc(n > 0 ? n : 1, sizeof(double));
+        acc.used = calloc(n > 0 ? n : 1, 1);
+        acc.hash_keys = malloc(SPARSE_HASH_LIMIT * sizeof(int));
+        acc.hash_values = malloc(SPARSE_HASH_LIMIT * sizeof(double));
+        acc.touched = malloc((n > 0 ? n : 1) * sizeof(int));
+        acc.entries = malloc((n > 0 ? n : 1) * sizeof(t_row_entry));
+        if (acc.dense == NULL || acc.used == NULL || acc.hash_keys == NULL || acc.hash_values == NULL ||
+            acc.touched == NULL || acc.entries == NULL) {
+            buffer->failed = 1;
+        } else {
+            for (int slot = 0; slot < SPARSE_HASH_LIMIT; slot++) acc.hash_keys[slot] = -1;
+        }
+#ifdef _OPENMP
+#pragma omp for schedule(static)
+#endif
+        for (int i = 0; i < n; i++) {
+            row_size[i] = 0;
+            if (buffer->failed) continue;
+            int nb_entries = accumulate_row(a, b, i, threshold, &acc);
+            if (!reserve_entries(buffer, nb_entries)) continue;
+            for (int t = 0; t < nb_entries; t++) {
+                buffer->columns[buffer->size + t] = acc.entries[t].column;
+                buffer->values[buffer->size + t] = (float)acc.entries[t].value;
+            }
+            buffer->size += nb_entries;
+            row_size[i] = nb_entries;
+        }
+        free(acc.dense);
+        free(acc.used);
+        free(acc.hash_keys);
+        free(acc.hash_values);
+        free(acc.touched);
+        free(acc.entries);
+    }
+    int failed = 0;
+    int nb_entries = 0;
+    for (int t = 0; t < nb_threads; t++) {
+        failed |= buffers[t].failed;
+        nb_entries += buffers[t].size;
+    }
+    t_sparse_matrix *product = failed ? NULL : create_sparse_matrix(n, nb_entries);
+    if (product != NULL) {
+        for (int i = 0; i < n; i++) product->row_start[i + 1] = product->row_start[i] + row_size[i];
+        int k = 0;
+        for (int t = 0; t < nb_threads; t++) {
+            if (buffers[t].size == 0) continue;  // a thread without rows has no buffer
+            memcpy(product->columns + k, buffers[t].columns, buffers[t].size * sizeof(int));
+            memcpy(product->values + k, buffers[t].values, buffers[t].size * sizeof(float));
+            k += buffers[t].size;
+        }
+    } else {
+        sparse_alloc_error();
+    }
+    for (int t = 0; t < nb_threads; t++) {
+        free(buffers[t].columns);
+        free(buffers[t].values);
+    }
+    free(buffers);
+    free(row_size);
+    return product;
+}
+
+static t_sparse_matrix* copy_sparse(const t_sparse_matrix *sparse) {
+    t_sparse_matrix *copy = create_sparse_matrix(sparse->size, sparse->nb_entries);
+    if (copy == NULL) return NULL;
+    memcpy(copy->row_start, sparse->row_start, (sparse->size + 1) * sizeof(int));
+    memcpy(copy->columns, sparse->columns, sparse->nb_entries * sizeof(int));
+    memcpy(copy->values, sparse->values, sparse->nb_entries * sizeof(float));
+    return copy;
+}
+
+// Function that computes the k-th power of a sparse matrix (k >= 1) by repeated squaring
+t_sparse_matrix* sparse_power(const t_sparse_matrix *sparse, int k, float threshold) {
+    if (sparse == NULL || k < 1) {
+        fprintf(stderr, "Error: Invalid input for the matrix power\n");
+        return NULL;
+    }
+    t_sparse_matrix *result = NULL;
+    t_sparse_matrix *square = NULL;
+    const t_sparse_matrix *base = sparse;
+    int failed = 0;
+    while (!failed) {
+        if (k & 1) {
+            t_sparse_matrix *next = (result == NULL) ? copy_sparse(base) : sparse_multiply(result, base, threshold);
+            free_sparse_matrix(result);
+            result = next;
+            failed = (result == NULL);
+        }
+        k >>= 1;
+        if (k == 0 || failed) break;
+        t_sparse_matrix *next = sparse_multiply(base, base, threshold);
+        free_sparse_matrix(square);
+        square = next;
+        base = square;
+        failed = (square == NULL);
+    }
+    free_sparse_matrix(square);
+    if (failed) {
+        sparse_alloc_error();
+        free_sparse_matrix(result);
+        return NULL;
+    }
+    return result;
+}
+
+// Function that reads one entry of a sparse matrix (0-based), by binary search in its row
+float sparse_get(const t_sparse_matrix *sparse, int i, int j) {
+    int low = sparse->row_start[i];
+    int high = sparse->row_start[i + 1] - 1;
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        if (sparse->columns[middle] == j) return sparse->values[middle];
+        if (sparse->columns[middle] < j) low = middle + 1;
+        else high = middle - 1;
+    }
+    return 0;
+}
+
+// Function that computes the sum of |m - n| over all entries, like matrix_difference,
+// by merging the rows: it costs the number of entries instead of n^2
+float sparse_matrix_difference(const t_sparse_matrix *m, const t_sparse_matrix *n) {
+    if (m == NULL || n == NULL) {
+        fprintf(stderr, "Error: Cannot compute difference for NULL matrices\n");
+        return -1.0;
+    }
+    if (m->size != n->size) {
+        fprintf(stderr, "Error: Matrices must be of the same size for difference calculation\n");
+        return -1.0;
+    }
+    double diff = 0;
+    for (int i = 0; i < m->size; i++) {
+        int p = m->row_start[i];
+        int q = n->row_start[i];
+        while (p < m->row_start[i + 1] || q < n->row_start[i + 1]) {
+            float difference;
+            if (q == n->row_start[i + 1] || (p < m->row_start[i + 1] && m->columns[p] < n->columns[q])) {
+                difference = m->values[p++];
+            } else if (p == m->row_start[i + 1] || n->columns[q] < m->columns[p]) {
+                difference = -n->values[q++];
+            } else {
+                difference = m->values[p++] - n->values[q++];
+            }
+            diff += (difference < 0) ? -difference : difference;
+        }
+    }
+    return (float)diff;
+}
+
+// Function that expands a sparse matrix into a dense one (only for small sizes)
+matrix* sparse_to_dense(const t_sparse_matrix *sparse) {
+    matrix *dense = create_zero_matrix(sparse->size);
+    if (dense == NULL) return NULL;
+    for (int i = 0; i < sparse->size; i++) {
+        for (int p = sparse->row_start[i]; p < sparse->row_start[i + 1]; p++) {
+            dense->data[i][sparse->columns[p]] = sparse->values[p];
+        }
+    }
+    return dense;
+}
+
+// Function that gives the memory used by a sparse matrix, in bytes
+size_t sparse_memory(const t_sparse_matrix *sparse) {
+    return sizeof(t_sparse_matrix) + (size_t)(sparse->size + 1) * sizeof(int) +
+           (size_t)sparse->nb_entries * (sizeof(int) + sizeof(float));
+}
+
+// Function that frees a sparse matrix
+void free_sparse_matrix(t_sparse_matrix *sparse) {
+    if (sparse == NULL) return;
+    free(sparse->row_start);
+    free(sparse->columns);
+    free(sparse->values);
+    free(sparse);
+}
@@ -0,0 +1,35 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef SPARSE_H
+#define SPARSE_H
+#include "functions.h"
+
+// Sparse square matrix, row by row (CSR): the non-zero entries of row i are
+// columns[row_start[i] .. row_start[i + 1] - 1] (0-based, increasing) with their values
+typedef struct {
+    int size;               // Matrix size (n x n)
+    int nb_entries;         // Number of stored entries
+    int *row_start;         // Start of each row in columns/values (size + 1 entries)
+    int *columns;           // Column of each entry
+    float *values;          // Value of each entry
+} t_sparse_matrix;
+
+t_sparse_matrix* sparse_from_graph(const a_list *);
+
+t_sparse_matrix* sparse_multiply(const t_sparse_matrix *, const t_sparse_matrix *, float);
+
+t_sparse_matrix* sparse_power(const t_sparse_matrix *, int, float);
+
+float sparse_get(const t_sparse_matrix *, int, int);
+
+float sparse_matrix_difference(const t_sparse_matrix *, const t_sparse_matrix *);
+
+matrix* sparse_to_dense(const t_sparse_matrix *);
+
+size_t sparse_memory(const t_sparse_matrix *);
+
+void free_sparse_matrix(t_sparse_matrix *);
+
+#endif //SPARSE_H
@@ -0,0 +1,392 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "spectral.h"
+#include <math.h>
+
+// Spectral gap of the persistent classes: a persistent class keeps all its edges, so its block of
+// the sparse graph is a stochastic matrix P with eigenvalue 1, left vector pi and right vector 1.
+// Row vectors whose entries sum to 0 stay that way under x -> xP (xP1 = x1 = 0), and this subspace
+// holds every other eigenvalue, the largest in modulus being the SLEM. A single power iterate does
+// not converge when the SLEM is a complex pair (it turns), so two vectors are iterated together
+// (block power iteration) and kept orthonormal: they span the invariant subspace of the two largest
+// eigenvalues of the subspace. The eigenvalues of the 2 x 2 projection H = V^T (VP) (Rayleigh-Ritz)
+// give the SLEM, real or complex, and the iteration stops when the residual |VP - VH| of the pair,
+// or of the largest real Ritz vector alone, is below the tolerance.
+// Each step costs two passes over the edges of the class, so a class costs O(k.E) for k steps.
+// The stationary distribution comes from the lazy chain (P + I) / 2, which converges on periodic
+// classes too; its smallest entry enters the mixing-time bound
+//     t_mix(eps) <= log(1 / (eps * pi_min)) / gap
+// which holds for reversible chains and is an estimate for the others.
+// Classes are independent and are handled in parallel.
+
+
+// Rows of one class with local indices
+typedef struct {
+    int size;
+    int *row_start;
+    int *columns;
+    double *values;
+} t_class_rows;
+
+static int build_class_rows(a_list *graph, const t_class *class, const int *local, t_class_rows *rows) {
+    int m = class->size;
+    int nb_edges = 0;
+    for (int i = 0; i < m; i++) nb_edges += graph->array[class->vertices[i].identifier].size;
+    rows->size = m;
+    rows->row_start = malloc((m + 1) * sizeof(int));
+    rows->columns = malloc((nb_edges > 0 ? nb_edges : 1) * sizeof(int));
+    rows->values = malloc((nb_edges > 0 ? nb_edges : 1) * sizeof(double));
+    if (rows->row_start == NULL || rows->columns == NULL || rows->values == NULL) return 0;
+    int k = 0;
+    for (int i = 0; i < m; i++) {
+        rows->row_start[i] = k;
+        for (cell *e = graph->array[class->vertices[i].identifier].head; e != NULL; e = e->next) {
+            rows->columns[k] = local[e->arr - 1];
+            rows->values[k] = e->proba;
+            k++;
+        }
+    }
+    rows->row_start[m] = k;
+    return 1;
+}
+
+static void free_class_rows(t_class_rows *rows) {
+    free(rows->row_start);
+    free(rows->columns);
+    free(rows->values);
+}
+
+// y = xP on the rows of a class
+static void left_step(const t_class_rows *rows, const double *x, double *y) {
+    for (int j = 0; j < rows->size; j++) y[j] = 0;
+    for (int i = 0; i < rows->size; i++) {
+        double xi = x[i];
+        if (xi == 0) continue;
+        for (int k = rows->row_start[i]; k < rows->row_start[i + 1]; k++) y[rows->columns[k]] += xi * rows->values[k];
+    }
+}
+
+// Stationary distribution by the lazy chain, returns the number of steps (negative if not converged)
+static int lazy_stationary(const t_class_rows *rows, double *pi, double *next, const t_spectral_options *options) {
+    int m = rows->size;
+    for (int i = 0; i < m; i++) pi[i] = 1.0 / m;
+    for (int step = 1; step <= options->max_iterations; step++) {
+        left_step(rows, pi, next);
+        double change = 0;
+        for (int i = 0; i < m; i++) {
+            double value = 0.5 * (pi[i] + next[i]);
+            change += (value > pi[i]) ? value - pi[i] : pi[i] - value;
+            pi[i] = value;
+        }
+        if (change < options->tolerance) return step;
+    }
+    return -options->max_iterations;
+}
+
+static double dot(const double *a, const double *b, int m) {
+    double sum = 0;
+    for (int i = 0; i < m; i++) sum += a[i] * b[i];
+    return sum;
+}
+
+// x -= mean of x (back into the zero-sum subspace, only rounding errors leave it)
+static void remove_mean(double *x, int m) {
+    double mean = 0;
+    for (int i = 0; i < m; i++) mean += x[i];
+    mean /= m;
+    for (int i = 0; i < m; i++) x[i] -= mean;
+}
+
+// Fixed pseudo-random zero-sum vector orthogonal to q (if given) and of norm 1,
+// so that it has a component on every eigenvector
+static void random_start(double *x, const double *q, int m, unsigned *seed) {
+    for (int i = 0; i < m; i++) {
+        *seed = *seed * 1103515245u + 12345u;
+        x[i] = (double)((*seed >> 16) & 0x7fff) / 0x7fff;
+    }
+    remove_mean(x, m);
+    if (q != NULL) {
+        double projection = dot(q, x, m);
+        for (int i = 0; i < m; i++) x[i] -= projection * q[i];
+    }
+    double norm = sqrt(dot(x, x, m));
+    for (int i = 0; i < m; i++) x[i] /= norm;
+}
+
+// Block power iteration on two vectors in the zero-sum subspace, gives the number of steps in
+// steps (negative if not converged) and returns 0 if the memory runs out
+static int second_modulus(const t_class_rows *rows, double *x, double *y, const t_spectral_options *options,
+                          unsigned seed, double *slem, int *steps) {
+    int m = rows->size;
+    int dimension = (m > 2) ? 2 : 1;  // the zero-sum subspace has dimension m - 1
+    int max_iterations = options->max_iterations;
+    *slem = 0;
+    *steps = 0;
+    double *log_norm = malloc((max_iterations + 1) * sizeof(double));  // cumulated log growth of v1
+    double *v2 = malloc(m * sizeof(double));
+    double *w2 = malloc(m * sizeof(double));
+    if (log_norm == NULL || v2 == NULL || w2 == NULL) {
+        free(log_norm);
+        free(v2);
+        free(w2);
+        return 0;
+    }
+    double *v1 = x;
+    double *w1 = y;
+    random_start(v1, NULL, m, &seed);
+    if (dimension == 2) random_start(v2, v1, m, &seed);
+    log_norm[0] = 0;
+    double modulus = 0;
+    for (int step = 1; step <= max_iterations; step++) {
+        left_step(rows, v1, w1);
+        remove_mean(w1, m);
+        double h00 = dot(v1, w1, m);
+        double h01 = 0, h10 = 0, h11 = 0;
+        if (dimension == 2) {
+            left_step(rows, v2, w2);
+            remove_mean(w2, m);
+            h01 = dot(v1, w2, m);
+            h10 = dot(v2, w1, m);
+            h11 = dot(v2, w2, m);
+        }
+        // Rayleigh-Ritz: H(a, b) = v_a . w_b, and its residual R = W - V H
+        double pair_residual = 0;
+        for (int i = 0; i < m; i++) {
+            double r1 = w1[i] - h00 * v1[i];
+            double r2 = 0;
+            if (dimension == 2) {
+                r1 -= h10 * v2[i];
+                r2 = w2[i] - h01 * v1[i] - h11 * v2[i];
+            }
+            pair_residual += r1 * r1 + r2 * r2;
+        }
+        pair_residual = sqrt(pair_residual);
+        double residual = pair_residual;
+        if (dimension == 1) {
+            modulus = fabs(h00);
+        } else {
+            double half_trace = (h00 + h11) / 2;
+            double determinant = h00 * h11 - h01 * h10;
+            double discriminant = half_trace * half_trace - determinant;
+            if (discriminant < 0) {
+                modulus = sqrt(determinant);  // complex pair
+            } else {
+                // real Ritz values: the largest one alone may converge before the pair
+                double root = sqrt(discriminant);
+                double theta = (fabs(half_trace + root) >= fabs(half_trace - root)) ? half_trace + root
+                                                                                    : half_trace - root;
+                modulus = fabs(theta);
+                double s0 = h01;
+                double s1 = theta - h00;
+                if (fabs(theta - h11) + fabs(h10) > fabs(s0) + fabs(s1)) {
+                    s0 = theta - h11;
+                    s1 = h10;
+                }
+                double s_norm = sqrt(s0 * s0 + s1 * s1);
+                if (s_norm > 0) {
+                    double single_residual = 0;
+                    for (int i = 0; i < m; i++) {
+                        double r = s0 * (w1[i] - theta * v1[i]) + s1 * (w2[i] - theta * v2[i]);
+                        single_residual += r * r;
+                    }
+                    single_residual = sqrt(single_residual) / s_norm;
+                    if (single_residual < residual) residual = single_residual;
+                }
+            }
+        }
+        *slem = (modulus < 1) ? modulus : 1;
+        if (residual < options->tolerance) {
+            free(log_norm);
+            free(v2);
+            free(w2);
+            *steps = step;
+            return 1;
+        }
+        // next basis: orthonormalised W (Gram-Schmidt, twice for the second vector)
+        double norm1 = sqrt(dot(w1, w1, m));
+        double norm2 = (dimension == 2) ? sqrt(dot(w2, w2, m)) : 0;
+        if (dimension == 2 && norm1 < 1e-12 * norm2) {
+            for (int i = 0; i < m; i++) {
+                double swap = w1[i];
+                w1[i] = w2[i];
+                w2[i] = swap;
+            }
+            double swap_norm = norm1;
+            norm1 = norm2;
+            norm2 = swap_norm;
+        }
+        if (norm1 < 1e-300) {
+            // the start vanished: every other eigenvalue is 0
+            free(log_norm);
+            free(v2);
+            free(w2);
+            *slem = 0;
+            *steps = step;
+            return 1;
+        }
+        log_norm[step] = log_norm[step - 1] + log(norm1);
+        for (int i = 0; i < m; i++) v1[i] = w1[i] / norm1;
+        if (dimension == 2) {
+            for (int pass = 0; pass < 2; pass++) {
+                double projection = dot(v1, w2, m);
+                for (int i = 0; i < m; i++) w2[i] -= projection * v1[i];
+            }
+            double norm = sqrt(dot(w2, w2, m));
+            if (norm < 1e-12 * norm2 || norm < 1e-300) {
+                random_start(v2, v1, m, &seed);  // W has rank 1: restart the second direction
+            } else {
+                for (int i = 0; i < m; i++) v2[i] = w2[i] / norm;
+            }
+        }
+    }
+    // not converged (e.g. several eigenvalues of the same modulus): keep the larger of the Ritz
+    // modulus and the average growth of v1 over the second half, the safer side for the gap
+    int half = max_iterations / 2;
+    if (max_iterations > half) {
+        double growth = exp((log_norm[max_iterations] - log_norm[half]) / (max_iterations - half));
+        if (growth > modulus) modulus = growth;
+    }
+    *slem = (modulus < 1) ? modulus : 1;
+    free(log_norm);
+    free(v2);
+    free(w2);
+    *steps = -max_iterations;
+    return 1;
+}
+
+// Estimates of one persistent class, returns 0 if the memory runs out
+static int analyse_class(a_list *graph, const t_class *class, const int *local, const t_spectral_options *options,
+                         double epsilon, t_class_spectrum *spectrum) {
+    spectrum->size = class->size;
+    if (class->size == 1) {
+        // an absorbing state is mixed from the start
+        spectrum->slem = 0;
+        spectrum->gap = 1;
+        spectrum->relaxation_time = 1;
+        spectrum->mixing_time = 0;
+        spectrum->min_stationary = 1;
+        spectrum->converged = 1;
+        return 1;
+    }
+    t_class_rows rows;
+    double *x = malloc(class->size * sizeof(double));
+    double *y = malloc(class->size * sizeof(double));
+    int ok = build_class_rows(graph, class, local, &rows) && x != NULL && y != NULL;
+    if (ok) {
+        int stationary_steps = lazy_stationary(&rows, x, y, options);
+        double min_stationary = 1;
+        for (int i = 0; i < class->size; i++) {
+            if (x[i] < min_stationary) min_stationary = x[i];
+        }
+        double slem;
+        int spectral_steps;
+        ok = second_modulus(&rows, x, y, options, 2166136261u + spectrum->class_index, &slem, &spectral_steps);
+        spectrum->slem = slem;
+        spectrum->gap = 1 - slem;
+        spectrum->min_stationary = min_stationary;
+        spectrum->iterations = abs(stationary_steps) + abs(spectral_steps);
+        spectrum->converged = stationary_steps > 0 && spectral_steps > 0;
+        if (spectrum->gap <= options->tolerance || min_stationary <= 0) {
+            spectrum->relaxation_time = -1;
+            spectrum->mixing_time = -1;
+        } else {
+            spectrum->relaxation_time = 1 / spectrum->gap;
+            spectrum->mixing_time = spectrum->relaxation_time * log(1 / (epsilon * min_stationary));
+            if (spectrum->mixing_time < 0) spectrum->mixing_time = 0;
+        }
+    }
+    free_class_rows(&rows);
+    free(x);
+    free(y);
+    return ok;
+}
+
+// Function that estimates the spectral gap and the mixing time of every persistent class
+// options may be NULL for the defaults (epsilon 0.25, tolerance 1e-6, 10000 steps)
+t_spectral_report* spectral_analysis(a_list *graph, t_partition *partition, const t_spectral_options *options) {
+    if (graph == NULL || graph->array == NULL || partition == NULL) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return NULL;
+    }
+    t_spectral_options defaults = {0.25, 1e-6, 10000};
+    if (options == NULL) options = &defaults;
+    if (options->max_iterations < 1) {
+        fprintf(stderr, "Error: The spectral analysis needs at least one iteration (sorry ;()\n");
+        return NULL;
+    }
+    int n = graph->size;
+    int *vertex_to_class = create_vertex_to_class(partition, n);
+    int *local = malloc((n > 0 ? n : 1) * sizeof(int));
+    int *persistent = malloc((partition->size > 0 ? partition->size : 1) * sizeof(int));
+    t_spectral_report *report = calloc(1, sizeof(t_spectral_report));
+    if (vertex_to_class == NULL || local == NULL || persistent == NULL || report == NULL) {
+        fprintf(stderr, "Memory allocation error for spectral analysis (sorry ;()\n");
+        free(vertex_to_class);
+        free(local);
+        free(persistent);
+        free(report);
+        return NULL;
+    }
+    // a class is persistent when no edge leaves it
+    int nb_persistent = 0;
+    for (int c = 0; c < partition->size; c++) {
+        int closed = 1;
+        for (int i = 0; i < partition->classes[c].size && closed; i++) {
+            int v = partition->classes[c].vertices[i].identifier;
+            for (cell *e = graph->array[v].head; e != NULL && closed; e = e->next) {
+                closed = (vertex_to_class[e->arr - 1] == c);
+            }
+        }
+        for (int i = 0; i < partition->classes[c].size; i++) local[partition->classes[c].vertices[i].identifier] = i;
+        if (closed) persistent[nb_persistent++] = c;
+    }
+    report->epsilon = options->epsilon;
+    report->nb_classes = nb_persistent;
+    report->classes = calloc(nb_persistent > 0 ? nb_persistent : 1, sizeof(t_class_spectrum));
+    int failed = (report->classes == NULL);
+    if (!failed) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic) reduction(|:failed)
+#endif
+        for (int p = 0; p < nb_persistent; p++) {
+            t_class_spectrum *spectrum = &report->classes[p];
+            spectrum->class_index = persistent[p];
+            failed |= !analyse_class(graph, &partition->classes[persistent[p]], local, options, options->epsilon,
+                                     spectrum);
+        }
+    }
+    free(vertex_to_class);
+    free(local);
+    free(persistent);
+    if (failed) {
+        fprintf(stderr, "Memory allocation error for spectral analysis (sorry ;()\n");
+        free_spectral_report(report);
+        return NULL;
+    }
+    return report;
+}
+
+// Function that displays the spectral estimates of the persistent classes
+void display_spectral_report(const t_spectral_report *report, const t_partition *partition) {
+    for (int p = 0; p < report->nb_classes; p++) {
+        const t_class_spectrum *spectrum = &report->classes[p];
+        printf("Class %s (%d states): SLEM %.6f, spectral gap %.6f", partition->classes[spectrum->class_index].name,
+               spectrum->size, spectrum->slem, spectrum->gap);
+        if (spectrum->relaxation_time < 0) {
+            printf(", never mixes (periodic class)");
+        } else {
+            printf(", relaxation time %.2f, mixing time <= %.2f steps (epsilon %.2f)", spectrum->relaxation_time,
+                   spectrum->mixing_time, report->epsilon);
+        }
+        printf("%s\n", spectrum->converged ? "" : " [not converged]");
+    }
+}
+
+// Function that frees a spectral report
+void free_spectral_report(t_spectral_report *report) {
+    if (report == NULL) return;
+    free(report->classes);
+    free(report);
+}
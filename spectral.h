@@ -0,0 +1,42 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef SPECTRAL_H
+#define SPECTRAL_H
+#include "functions.h"
+
+// Parameters of the spectral estimation
+typedef struct {
+    double epsilon;         // Total variation distance that defines the mixing time (0.25 is usual)
+    double tolerance;       // Stop when the Ritz residual (and the change of pi) is below this
+    int max_iterations;     // Maximum number of steps per class (for each of the two iterations)
+} t_spectral_options;
+
+// Spectral estimates of one persistent class
+typedef struct {
+    int class_index;        // Index of the class in the partition
+    int size;               // Number of states of the class
+    double slem;            // Second largest eigenvalue modulus of the class block
+    double gap;             // Spectral gap 1 - slem
+    double relaxation_time; // 1 / gap (-1 when the gap is 0: periodic class)
+    double mixing_time;     // Steps to get within epsilon of the stationary distribution (-1 when infinite)
+    double min_stationary;  // Smallest stationary probability of the class
+    int iterations;         // Steps done by the power iterations
+    int converged;          // 1 if both iterations reached the tolerance
+} t_class_spectrum;
+
+// Spectral estimates of every persistent class of a graph
+typedef struct {
+    t_class_spectrum *classes;
+    int nb_classes;
+    double epsilon;         // Threshold the mixing times refer to
+} t_spectral_report;
+
+t_spectral_report* spectral_analysis(a_list *, t_partition *, const t_spectral_options *);
+
+void display_spectral_report(const t_spectral_report *, const t_partition *);
+
+void free_spectral_report(t_spectral_report *);
+
+#endif //SPECTRAL_H
@@ -0,0 +1,199 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "stationary.h"
+
+// Stationary distribution of an irreducible sparse chain by Gauss-Southwell residual pushing.
+// With the residual r = xP - x, the Gauss-Seidel update of vertex j is x(j) += r(j) / (1 - P(j,j));
+// it clears r(j) and adds the same amount times P(j,k) to the residual of each successor k. Only
+// vertices whose residual is above tolerance / n are pushed, so that at the end the residual sums
+// to at most the tolerance, and the work goes where the residual is.
+// The vertices waiting to be pushed are taken in sweeps of increasing index (a heap ordered by
+// sweep, then by vertex): a successor of higher index is pushed in the same sweep, as in a
+// Gauss-Seidel sweep, which carries the residual along a path in one sweep where a FIFO order
+// needs one round per step (on long cycles this is the difference between converging or not).
+// Each row is divided by its sum in double: float probabilities rarely sum to exactly 1, and P
+// would then have no exact fixed point, which stops the residual around 1e-8.
+// After a few edits the old distribution is still an almost exact solution: its residual is zero
+// except around the edited rows, so a warm start from it only pushes the part of the chain that the
+// edits really move, instead of the whole chain many times over for a cold start.
+
+
+#define STATIONARY_MAX_PUSHES 10000LL  // Pushes allowed per vertex
+
+static void heap_push(int *heap, const long long *key, int *size, int v) {
+    int position = (*size)++;
+    while (position > 0 && key[heap[(position - 1) / 2]] > key[v]) {
+        heap[position] = heap[(position - 1) / 2];
+        position = (position - 1) / 2;
+    }
+    heap[position] = v;
+}
+
+static int heap_pop(int *heap, const long long *key, int *size) {
+    int top = heap[0];
+    int last = heap[--(*size)];
+    int position = 0;
+    while (2 * position + 1 < *size) {
+        int child = 2 * position + 1;
+        if (child + 1 < *size && key[heap[child + 1]] < key[heap[child]]) child++;
+        if (key[last] <= key[heap[child]]) break;
+        heap[position] = heap[child];
+        position = child;
+    }
+    heap[position] = last;
+    return top;
+}
+
+// Push the residual of x until every vertex is below tolerance / n, then normalise x
+static t_stationary_result* push_solve(a_list *graph, double *x, double tolerance) {
+    int n = graph->size;
+    t_stationary_result *result = calloc(1, sizeof(t_stationary_result));
+    double *residual = calloc(n > 0 ? n : 1, sizeof(double));
+    double *self_loop = calloc(n > 0 ? n : 1, sizeof(double));
+    double *row_scale = malloc((n > 0 ? n : 1) * sizeof(double));
+    int *heap = malloc((n > 0 ? n : 1) * sizeof(int));
+    long long *key = malloc((n > 0 ? n : 1) * sizeof(long long));
+    char *queued = calloc(n > 0 ? n : 1, 1);
+    if (result == NULL || residual == NULL || self_loop == NULL || row_scale == NULL || heap == NULL ||
+        key == NULL || queued == NULL) {
+        fprintf(stderr, "Memory allocation error for stationary distribution (sorry ;()\n");
+        free(result);
+        free(residual);
+        free(self_loop);
+        free(row_scale);
+        free(heap);
+        free(key);
+        free(queued);
+        free(x);
+        return NULL;
+    }
+    // r = xP - x, in one pass over the edges
+    for (int i = 0; i < n; i++) {
+        double sum = 0;
+        for (cell *e = graph->array[i].head; e != NULL; e = e->next) sum += e->proba;
+        row_scale[i] = (sum > 0) ? 1 / sum : 0;
+        for (cell *e = graph->array[i].head; e != NULL; e = e->next) {
+            residual[e->arr - 1] += x[i] * e->proba * row_scale[i];
+            if (e->arr - 1 == i) self_loop[i] = e->proba * row_scale[i];
+        }
+    }
+    double threshold = tolerance / (n > 0 ? n : 1);
+    int nb_queued = 0;
+    for (int j = 0; j < n; j++) {
+        residual[j] -= x[j];
+        if (residual[j] > threshold || residual[j] < -threshold) {
+            key[j] = j;  // first sweep, already in heap order
+            heap[nb_queued++] = j;
+            queued[j] = 1;
+        }
+    }
+    long long max_pushes = STATIONARY_MAX_PUSHES * n;
+    while (nb_queued > 0 && result->pushes < max_pushes) {
+        int j = heap_pop(heap, key, &nb_queued);
+        queued[j] = 0;
+        long long sweep = key[j] / n;
+        double remaining = 1 - self_loop[j];
+        if (remaining < 1e-12) continue;  // absorbing: the chain is not irreducible
+        double delta = residual[j] / remaining;
+        double flow = delta * row_scale[j];
+        x[j] += delta;
+        residual[j] = 0;
+        result->pushes++;
+        for (cell *e = graph->array[j].head; e != NULL; e = e->next) {
+            int k = e->arr - 1;
+            if (k == j) continue;
+            residual[k] += flow * e->proba;
+            if (!queued[k] && (residual[k] > threshold || residual[k] < -threshold)) {
+                key[k] = (k > j ? sweep : sweep + 1) * n + k;
+                heap_push(heap, key, &nb_queued, k);
+                queued[k] = 1;
+            }
+        }
+    }
+    double sum = 0;
+    for (int j = 0; j < n; j++) sum += x[j];
+    double total_residual = 0;
+    for (int j = 0; j < n; j++) {
+        x[j] /= sum;
+        total_residual += (residual[j] < 0) ? -residual[j] : residual[j];
+    }
+    result->size = n;
+    result->distribution = x;
+    result->residual = total_residual / sum;
+    result->converged = (result->residual <= tolerance);
+    free(residual);
+    free(self_loop);
+    free(row_scale);
+    free(heap);
+    free(key);
+    free(queued);
+    return result;
+}
+
+// Function that computes the stationary distribution of an irreducible graph from a uniform start
+// (the sum of |pi P - pi| ends below tolerance)
+t_stationary_result* stationary_distribution(a_list *graph, double tolerance) {
+    if (graph == NULL || graph->array == NULL || graph->size <= 0 || tolerance <= 0) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return NULL;
+    }
+    double *x = malloc(graph->size * sizeof(double));
+    if (x == NULL) {
+        fprintf(stderr, "Memory allocation error for stationary distribution (sorry ;()\n");
+        return NULL;
+    }
+    for (int j = 0; j < graph->size; j++) x[j] = 1.0 / graph->size;
+    return push_solve(graph, x, tolerance);
+}
+
+// Function that applies edits to a graph and updates its stationary distribution, starting from
+// the previous one (the graph must stay irreducible and its rows stochastic once all edits are done)
+t_stationary_result* update_stationary(a_list *graph, const double *previous, const t_row_edit *edits, int nb_edits,
+                                       double tolerance) {
+    if (graph == NULL || graph->array == NULL || graph->size <= 0 || previous == NULL || tolerance <= 0 ||
+        (edits == NULL && nb_edits > 0)) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return NULL;
+    }
+    for (int k = 0; k < nb_edits; k++) {
+        const t_row_edit *edit = &edits[k];
+        if (edit->from < 1 || edit->from > graph->size || edit->to < 1 || edit->to > graph->size) {
+            fprintf(stderr, "Warning: ignoring out-of-range edit %d -> %d\n", edit->from, edit->to);
+            continue;
+        }
+        list *row = &graph->array[edit->from - 1];
+        if (edit->proba <= 0) {
+            remove_cell(row, edit->to);
+        } else {
+            cell *existing = find_cell(row, edit->to);
+            if (existing != NULL) {
+                existing->proba = edit->proba;
+            } else {
+                insert_cell(row, edit->to, edit->proba);
+            }
+        }
+    }
+    double *x = malloc(graph->size * sizeof(double));
+    if (x == NULL) {
+        fprintf(stderr, "Memory allocation error for stationary distribution (sorry ;()\n");
+        return NULL;
+    }
+    memcpy(x, previous, graph->size * sizeof(double));
+    return push_solve(graph, x, tolerance);
+}
+
+// Function that displays a stationary distribution
+void display_stationary_result(const t_stationary_result *result) {
+    for (int j = 0; j < result->size; j++) printf("  State %d: %.6f\n", j + 1, result->distribution[j]);
+    printf("%lld pushes, residual %.2e%s\n", result->pushes, result->residual,
+           result->converged ? "" : " (not converged)");
+}
+
+// Function that frees a stationary distribution
+void free_stationary_result(t_stationary_result *result) {
+    if (result == NULL) return;
+    free(result->distribution);
+    free(result);
+}
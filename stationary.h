@@ -0,0 +1,33 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef STATIONARY_H
+#define STATIONARY_H
+#include "functions.h"
+
+// New probability of one edge (0 removes it)
+typedef struct {
+    int from;       // 1-based vertices
+    int to;
+    float proba;
+} t_row_edit;
+
+// Stationary distribution found by residual pushing
+typedef struct {
+    int size;               // Number of vertices
+    double *distribution;   // Stationary probability of each vertex
+    double residual;        // Sum of |pi P - pi| at the end
+    long long pushes;       // Number of vertices pushed
+    int converged;          // 1 if the residual reached the tolerance
+} t_stationary_result;
+
+t_stationary_result* stationary_distribution(a_list *, double);
+
+t_stationary_result* update_stationary(a_list *, const double *, const t_row_edit *, int, double);
+
+void display_stationary_result(const t_stationary_result *);
+
+void free_stationary_result(t_stationary_result *);
+
+#endif //STATIONARY_H
@@ -0,0 +1,36 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include <math.h>
+#include "ctmc.h"
+
+// Regression: a fast rate 1 -> 2 followed by a very slow rate 2 -> 3. The vector barely changes
+// once state 1 is empty, but the mass still has to flow from 2 to 3 until t = 5000.
+int main(void) {
+    a_list *rates = create_a_list(3);
+    insert_cell(&rates->array[0], 2, 1.0f);
+    insert_cell(&rates->array[1], 3, 0.001f);
+    double initial[3] = {1, 0, 0};
+    double a = 1.0;
+    double b = (double)0.001f;
+    double exact[3];
+    exact[0] = exp(-a * 5000);
+    exact[1] = a / (a - b) * (exp(-b * 5000) - exp(-a * 5000));
+    exact[2] = 1 - exact[0] - exact[1];
+    int failed = 0;
+    double epsilons[2] = {1e-4, 1e-8};
+    for (int k = 0; k < 2; k++) {
+        t_ctmc_transient *transient = ctmc_transient(rates, initial, 5000, epsilons[k]);
+        if (transient == NULL) return 1;
+        for (int v = 0; v < 3; v++) {
+            if (fabs(transient->distribution[v] - exact[v]) > epsilons[k]) {
+                printf("epsilon %g, state %d: %.8f instead of %.8f\n", epsilons[k], v + 1,
+                       transient->distribution[v], exact[v]);
+                failed = 1;
+            }
+        }
+        free_ctmc_transient(transient);
+    }
+    return failed;
+}
@@ -0,0 +1,39 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include <math.h>
+#include "spectral.h"
+
+// Regression: the 4-state chain of the demo (data/exemple1.txt) has a complex pair
+// 0.822787 +- 0.027161i as second eigenvalues, of modulus 0.823235, which a single power
+// iterate only approaches like O(1 / steps) while reporting convergence too early.
+int main(void) {
+    a_list *graph = create_a_list(4);
+    insert_cell(&graph->array[0], 1, 0.95f);
+    insert_cell(&graph->array[0], 2, 0.04f);
+    insert_cell(&graph->array[0], 3, 0.01f);
+    insert_cell(&graph->array[1], 2, 0.9f);
+    insert_cell(&graph->array[1], 3, 0.05f);
+    insert_cell(&graph->array[1], 4, 0.05f);
+    insert_cell(&graph->array[2], 3, 0.8f);
+    insert_cell(&graph->array[2], 4, 0.2f);
+    insert_cell(&graph->array[3], 1, 1.0f);
+    t_partition partition = compute_partition(graph);
+    t_spectral_report *report = spectral_analysis(graph, &partition, NULL);
+    if (report == NULL || report->nb_classes != 1) return 1;
+    double expected = 0.823234862;  // modulus of the pair, computed for the float probabilities
+    const t_class_spectrum *spectrum = &report->classes[0];
+    int failed = !spectrum->converged || fabs(spectrum->slem - expected) > 1e-6;
+    if (failed) printf("SLEM %.9f instead of %.9f (converged %d)\n", spectrum->slem, expected, spectrum->converged);
+    free_spectral_report(report);
+    for (int c = 0; c < partition.size; c++) {
+        free(partition.classes[c].name);
+        free(partition.classes[c].vertices);
+    }
+    free(partition.classes);
+    for (int v = 0; v < graph->size; v++) free_list(&graph->array[v]);
+    free(graph->array);
+    free(graph);
+    return failed;
+}
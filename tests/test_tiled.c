@@ -0,0 +1,45 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "tiled.h"
+
+// Regression: with the A panel in memory, a dense A and a B with few tiles used to fill the
+// request plan with A reads past its end. The product must match the in-memory one.
+int main(void) {
+    int n = 8;
+    int b = 2;
+    int b_tiles[6][2] = {{0, 0}, {0, 1}, {1, 2}, {2, 3}, {3, 0}, {3, 3}};
+    matrix *a = create_zero_matrix(n);
+    matrix *m = create_zero_matrix(n);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) a->data[i][j] = (float)(i + j + 1) / 64;
+    }
+    for (int t = 0; t < 6; t++) {
+        for (int i = 0; i < b; i++) {
+            for (int j = 0; j < b; j++) m->data[b_tiles[t][0] * b + i][b_tiles[t][1] * b + j] = (float)(t + i + j + 1) / 8;
+        }
+    }
+    t_tiled_matrix *tiled_a = tiled_from_matrix(a, "test_tiled_a.bin", b);
+    t_tiled_matrix *tiled_b = tiled_from_matrix(m, "test_tiled_b.bin", b);
+    if (tiled_a == NULL || tiled_b == NULL) return 1;
+    size_t budget = 100 * (size_t)b * b * sizeof(float);
+    t_tiled_matrix *tiled_c = multiply_tiled(tiled_a, tiled_b, "test_tiled_c.bin", budget);
+    if (tiled_c == NULL) return 1;
+    matrix *c = tiled_to_matrix(tiled_c);
+    matrix *expected = multiply_matrices(a, m);
+    float difference = matrix_difference(c, expected);
+    int failed = (difference > 1e-5f);
+    if (failed) printf("Tiled product differs from the in-memory one by %f\n", difference);
+    close_tiled_matrix(tiled_a);
+    close_tiled_matrix(tiled_b);
+    close_tiled_matrix(tiled_c);
+    remove("test_tiled_a.bin");
+    remove("test_tiled_b.bin");
+    remove("test_tiled_c.bin");
+    free_matrix(a);
+    free_matrix(m);
+    free_matrix(c);
+    free_matrix(expected);
+    return failed;
+}
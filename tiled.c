@@ -0,0 +1,449 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#define _FILE_OFFSET_BITS 64
+#include "tiled.h"
+#include <pthread.h>
+
+// Out-of-core matrices: the tiles live in a file and only a few of them are in memory.
+// multiply_tiled streams the tiles through a fixed memory budget. A reader thread fetches
+// the tiles ahead of the computation into a ring of buffers, so disk reads and products overlap.
+// Tiles known to be zero are neither read nor written (the file is created sparse).
+
+#ifdef _WIN32
+#define tiled_seek _fseeki64
+#else
+#define tiled_seek fseeko
+#endif
+
+#define MAX_PREFETCH_SLOTS 8
+
+
+static long long tile_offset(const t_tiled_matrix *t, int row, int col) {
+    long long tile_floats = (long long)t->tile_size * t->tile_size;
+    return ((long long)row * t->nb_tiles + col) * tile_floats * (long long)sizeof(float);
+}
+
+static t_tiled_matrix* new_tiled_matrix(const char *path, int size, int tile_size, const char *mode) {
+    if (size <= 0 || tile_size <= 0) {
+        fprintf(stderr, "Error: Matrix and tile sizes must be positive\n");
+        return NULL;
+    }
+    t_tiled_matrix *t = malloc(sizeof(t_tiled_matrix));
+    if (t == NULL) {
+        fprintf(stderr, "Memory allocation error for tiled matrix (sorry ;()\n");
+        return NULL;
+    }
+    t->size = size;
+    t->tile_size = tile_size;
+    t->nb_tiles = (size + tile_size - 1) / tile_size;
+    t->path = malloc(strlen(path) + 1);
+    t->nonzero = malloc((size_t)t->nb_tiles * t->nb_tiles);
+    t->file = fopen(path, mode);
+    if (t->path == NULL || t->nonzero == NULL || t->file == NULL) {
+        if (t->file == NULL) perror("Could not open tile file");
+        else fprintf(stderr, "Memory allocation error for tiled matrix (sorry ;()\n");
+        if (t->file != NULL) fclose(t->file);
+        free(t->path);
+        free(t->nonzero);
+        free(t);
+        return NULL;
+    }
+    strcpy(t->path, path);
+    return t;
+}
+
+// Function that creates a zero matrix in a new tile file (the file is extended without writing)
+t_tiled_matrix* create_tiled_matrix(const char *path, int size, int tile_size) {
+    t_tiled_matrix *t = new_tiled_matrix(path, size, tile_size, "w+b");
+    if (t == NULL) return NULL;
+    memset(t->nonzero, 0, (size_t)t->nb_tiles * t->nb_tiles);
+    long long end = tile_offset(t, t->nb_tiles - 1, t->nb_tiles - 1) +
+                    (long long)tile_size * tile_size * (long long)sizeof(float);
+    unsigned char zero = 0;
+    if (tiled_seek(t->file, end - 1, SEEK_SET) != 0 || fwrite(&zero, 1, 1, t->file) != 1) {
+        perror("Could not extend tile file");
+        close_tiled_matrix(t);
+        return NULL;
+    }
+    return t;
+}
+
+// Function that opens an existing tile file (every tile is assumed to hold nonzero values)
+t_tiled_matrix* open_tiled_matrix(const char *path, int size, int tile_size) {
+    t_tiled_matrix *t = new_tiled_matrix(path, size, tile_size, "r+b");
+    if (t == NULL) return NULL;
+    memset(t->nonzero, 1, (size_t)t->nb_tiles * t->nb_tiles);
+    return t;
+}
+
+// Function that closes a tiled matrix (the file stays on disk)
+void close_tiled_matrix(t_tiled_matrix *t) {
+    if (t == NULL) return;
+    fclose(t->file);
+    free(t->path);
+    free(t->nonzero);
+    free(t);
+}
+
+static int read_tile_from(FILE *file, t_tiled_matrix *t, int row, int col, float *buffer) {
+    size_t count = (size_t)t->tile_size * t->tile_size;
+    if (tiled_seek(file, tile_offset(t, row, col), SEEK_SET) != 0) return 0;
+    return fread(buffer, sizeof(float), count, file) == count;
+}
+
+// Function that reads tile (row, col). Returns 1 on success
+int read_tile(t_tiled_matrix *t, int row, int col, float *buffer) {
+    return read_tile_from(t->file, t, row, col, buffer);
+}
+
+// Function that writes tile (row, col). Returns 1 on success
+int write_tile(t_tiled_matrix *t, int row, int col, const float *buffer) {
+    size_t count = (size_t)t->tile_size * t->tile_size;
+    if (tiled_seek(t->file, tile_offset(t, row, col), SEEK_SET) != 0 ||
+        fwrite(buffer, sizeof(float), count, t->file) != count) {
+        perror("Could not write tile");
+        return 0;
+    }
+    int nonzero = 0;
+    for (size_t i = 0; i < count && !nonzero; i++) nonzero = (buffer[i] != 0);
+    t->nonzero[(size_t)row * t->nb_tiles + col] = (unsigned char)nonzero;
+    return 1;
+}
+
+// Function that builds the tiled transition matrix of a graph, one row of tiles at a time
+// (the dense matrix is never in memory, only one tile and the edges of tile_size rows)
+t_tiled_matrix* tiled_from_graph(a_list *graph, const char *path, int tile_size) {
+    t_tiled_matrix *t = create_tiled_matrix(path, graph->size, tile_size);
+    if (t == NULL) return NULL;
+    int b = tile_size;
+    float *tile = malloc((size_t)b * b * sizeof(float));
+    cell **rows = calloc(b, sizeof(cell *));
+    int *degree = calloc(b, sizeof(int));
+    int *cursor = calloc(b, sizeof(int));
+    int ok = (tile != NULL && rows != NULL && degree != NULL && cursor != NULL);
+    for (int I = 0; I < t->nb_tiles && ok; I++) {
+        int first = I * b;
+        int nb_rows = (first + b <= graph->size) ? b : graph->size - first;
+        // sorted copy of the edges of the rows of this tile row
+        for (int r = 0; r < nb_rows && ok; r++) {
+            degree[r] = 0;
+            cursor[r] = 0;
+            for (cell *c = graph->array[first + r].head; c != NULL; c = c->next) degree[r]++;
+            free(rows[r]);
+            rows[r] = malloc((degree[r] > 0 ? degree[r] : 1) * sizeof(cell));
+            if (rows[r] == NULL) {
+                ok = 0;
+                break;
+            }
+            int k = 0;
+            for (cell *c = graph->array[first + r].head; c != NULL; c = c->next) rows[r][k++] = *c;
+            qsort(rows[r], degree[r], sizeof(cell), compare_cells);
+        }
+        for (int J = 0; J < t->nb_tiles && ok; J++) {
+            int nonzero = 0;
+            memset(tile, 0, (size_t)b * b * sizeof(float));
+            for (int r = 0; r < nb_rows; r++) {
+                while (cursor[r] < degree[r] && rows[r][cursor[r]].arr - 1 < (J + 1) * b) {
+                    int j = rows[r][cursor[r]].arr - 1 - J * b;
+                    tile[(size_t)r * b + j] += rows[r][cursor[r]].proba;
+                    nonzero = 1;
+                    cursor[r]++;
+                }
+            }
+            if (nonzero) ok = write_tile(t, I, J, tile);
+        }
+    }
+    if (rows != NULL) {
+        for (int r = 0; r < b; r++) free(rows[r]);
+    }
+    free(rows);
+    free(degree);
+    free(cursor);
+    free(tile);
+    if (!ok) {
+        fprintf(stderr, "Error: Could not build the tiled matrix\n");
+        close_tiled_matrix(t);
+        return NULL;
+    }
+    return t;
+}
+
+// Function that stores an in-memory matrix as tiles
+t_tiled_matrix* tiled_from_matrix(matrix *m, const char *path, int tile_size) {
+    t_tiled_matrix *t = create_tiled_matrix(path, m->size, tile_size);
+    if (t == NULL) return NULL;
+    int b = tile_size;
+    float *tile = malloc((size_t)b * b * sizeof(float));
+    int ok = (tile != NULL);
+    for (int I = 0; I < t->nb_tiles && ok; I++) {
+        for (int J = 0; J < t->nb_tiles && ok; J++) {
+            memset(tile, 0, (size_t)b * b * sizeof(float));
+            for (int i = I * b; i < (I + 1) * b && i < m->size; i++) {
+                for (int j = J * b; j < (J + 1) * b && j < m->size; j++) {
+                    tile[(size_t)(i - I * b) * b + (j - J * b)] = m->data[i][j];
+                }
+            }
+            ok = write_tile(t, I, J, tile);
+        }
+    }
+    free(tile);
+    if (!ok) {
+        close_tiled_matrix(t);
+        return NULL;
+    }
+    return t;
+}
+
+// Function that loads a tiled matrix in memory (only for matrices that fit)
+matrix* tiled_to_matrix(t_tiled_matrix *t) {
+    matrix *m = create_zero_matrix(t->size);
+    int b = t->tile_size;
+    float *tile = malloc((size_t)b * b * sizeof(float));
+    if (m == NULL || tile == NULL) {
+        fprintf(stderr, "Memory allocation error for matrix (sorry ;()\n");
+        free(tile);
+        return m;
+    }
+    fflush(t->file);
+    for (int I = 0; I < t->nb_tiles; I++) {
+        for (int J = 0; J < t->nb_tiles; J++) {
+            if (!t->nonzero[(size_t)I * t->nb_tiles + J]) continue;
+            if (!read_tile(t, I, J, tile)) {
+                fprintf(stderr, "Error: Could not read tile (%d, %d)\n", I, J);
+                continue;
+            }
+            for (int i = I * b; i < (I + 1) * b && i < t->size; i++) {
+                for (int j = J * b; j < (J + 1) * b && j < t->size; j++) {
+                    m->data[i][j] = tile[(size_t)(i - I * b) * b + (j - J * b)];
+                }
+            }
+        }
+    }
+    free(tile);
+    return m;
+}
+
+
+// Tile read planned by multiply_tiled
+typedef struct {
+    int from_b;     // 0 = tile (I, K) of A, 1 = tile (K, J) of B
+    int i, j, k;    // Tile indices of the product step
+} t_tile_request;
+
+// Reader thread state: the requests are read in order into a ring of slots
+typedef struct {
+    t_tile_request *requests;
+    long long nb_requests;
+    t_tiled_matrix *a;
+    t_tiled_matrix *b;
+    FILE *file_a;               // Reader's own handles, the computing thread keeps the others
+    FILE *file_b;
+    float **slots;
+    int nb_slots;
+    long long produced;         // Requests read so far
+    long long consumed;         // Requests released by the computing thread
+    int error;
+    pthread_mutex_t lock;
+    pthread_cond_t not_full;
+    pthread_cond_t not_empty;
+} t_prefetcher;
+
+static void *prefetch_tiles(void *argument) {
+    t_prefetcher *p = argument;
+    for (long long r = 0; r < p->nb_requests; r++) {
+        pthread_mutex_lock(&p->lock);
+        while (p->produced - p->consumed >= p->nb_slots) pthread_cond_wait(&p->not_full, &p->lock);
+        pthread_mutex_unlock(&p->lock);
+        // the slot is free: read outside the lock
+        t_tile_request *q = &p->requests[r];
+        float *slot = p->slots[r % p->nb_slots];
+        int ok = q->from_b ? read_tile_from(p->file_b, p->b, q->k, q->j, slot)
+                           : read_tile_from(p->file_a, p->a, q->i, q->k, slot);
+        pthread_mutex_lock(&p->lock);
+        if (!ok) p->error = 1;
+        p->produced++;
+        pthread_cond_signal(&p->not_empty);
+        pthread_mutex_unlock(&p->lock);
+    }
+    return NULL;
+}
+
+static float *wait_tile(t_prefetcher *p, long long r) {
+    pthread_mutex_lock(&p->lock);
+    while (p->produced <= r) pthread_cond_wait(&p->not_empty, &p->lock);
+    pthread_mutex_unlock(&p->lock);
+    return p->slots[r % p->nb_slots];
+}
+
+static void release_tile(t_prefetcher *p) {
+    pthread_mutex_lock(&p->lock);
+    p->consumed++;
+    pthread_cond_signal(&p->not_full);
+    pthread_mutex_unlock(&p->lock);
+}
+
+// c += a * b on b x b tiles (i-k-j order, the inner loop runs along rows)
+static void multiply_add_tile(float *c, const float *a, const float *b, int size) {
+    for (int i = 0; i < size; i++) {
+        float *c_row = &c[(size_t)i * size];
+        for (int k = 0; k < size; k++) {
+            float a_ik = a[(size_t)i * size + k];
+            if (a_ik == 0) continue;
+            const float *b_row = &b[(size_t)k * size];
+            for (int j = 0; j < size; j++) c_row[j] += a_ik * b_row[j];
+        }
+    }
+}
+
+// Grow the request plan so that it holds at least needed requests (0 on allocation failure)
+static int reserve_requests(t_tile_request **requests, long long *capacity, long long needed) {
+    if (needed <= *capacity) return 1;
+    long long grown_capacity = *capacity;
+    while (grown_capacity < needed) grown_capacity *= 2;
+    t_tile_request *grown = realloc(*requests, grown_capacity * sizeof(t_tile_request));
+    if (grown == NULL) return 0;
+    *requests = grown;
+    *capacity = grown_capacity;
+    return 1;
+}
+
+// Function that multiplies two tiled matrices into a new tile file, using at most about
+// memory_budget bytes of tile buffers. The row of tiles of A is kept in memory when the
+// budget allows it, otherwise A and B tiles are both streamed.
+t_tiled_matrix* multiply_tiled(t_tiled_matrix *a, t_tiled_matrix *b, const char *path, size_t memory_budget) {
+    if (a == NULL || b == NULL || a->size != b->size || a->tile_size != b->tile_size) {
+        fprintf(stderr, "Error: Tiled matrices must have the same size and tile size for multiplication\n");
+        return NULL;
+    }
+    int nb = a->nb_tiles;
+    size_t tile_floats = (size_t)a->tile_size * a->tile_size;
+    size_t tile_bytes = tile_floats * sizeof(float);
+    long long budget_tiles = (long long)(memory_budget / tile_bytes);
+    if (budget_tiles < 4) {
+        fprintf(stderr, "Error: The memory budget must hold at least 4 tiles (%zu bytes)\n", 4 * tile_bytes);
+        return NULL;
+    }
+    // product tile + A tiles + prefetch ring
+    int panel = (budget_tiles >= nb + 3) ? nb : 1;
+    long long free_tiles = budget_tiles - 1 - panel;
+    int nb_slots = (free_tiles > MAX_PREFETCH_SLOTS) ? MAX_PREFETCH_SLOTS : (int)free_tiles;
+    if (panel == 1 && nb_slots < 2) nb_slots = 2;
+    // plan the reads, skipping the products of zero tiles
+    long long nb_requests = 0;
+    long long capacity = 2 * (long long)nb * nb;
+    t_tile_request *requests = malloc(capacity * sizeof(t_tile_request));
+    if (requests == NULL) {
+        fprintf(stderr, "Memory allocation error for tiled product (sorry ;()\n");
+        return NULL;
+    }
+    int planned = 1;
+    for (int I = 0; I < nb && planned; I++) {
+        if (panel > 1) {
+            planned = reserve_requests(&requests, &capacity, nb_requests + nb + 2);
+            for (int K = 0; K < nb && planned; K++) {
+                if (a->nonzero[(size_t)I * nb + K]) requests[nb_requests++] = (t_tile_request){0, I, 0, K};
+            }
+        }
+        for (int J = 0; J < nb && planned; J++) {
+            for (int K = 0; K < nb && planned; K++) {
+                if (!a->nonzero[(size_t)I * nb + K] || !b->nonzero[(size_t)K * nb + J]) continue;
+                planned = reserve_requests(&requests, &capacity, nb_requests + 2);
+                if (!planned) break;
+                if (panel == 1) requests[nb_requests++] = (t_tile_request){0, I, J, K};
+                requests[nb_requests++] = (t_tile_request){1, I, J, K};
+            }
+        }
+    }
+    if (!planned) {
+        fprintf(stderr, "Memory allocation error for tiled product (sorry ;()\n");
+        free(requests);
+        return NULL;
+    }
+    t_tiled_matrix *c = create_tiled_matrix(path, a->size, a->tile_size);
+    if (c == NULL) {
+        free(requests);
+        return NULL;
+    }
+    fflush(a->file);
+    fflush(b->file);
+    t_prefetcher p;
+    p.requests = requests;
+    p.nb_requests = nb_requests;
+    p.a = a;
+    p.b = b;
+    p.file_a = fopen(a->path, "rb");
+    p.file_b = fopen(b->path, "rb");
+    p.nb_slots = nb_slots;
+    p.slots = calloc(nb_slots, sizeof(float *));
+    p.produced = 0;
+    p.consumed = 0;
+    p.error = 0;
+    float **a_tiles = calloc(panel, sizeof(float *));
+    float *product = malloc(tile_bytes);
+    int ok = (p.file_a != NULL && p.file_b != NULL && p.slots != NULL && a_tiles != NULL && product != NULL);
+    for (int s = 0; s < nb_slots && ok; s++) ok = ((p.slots[s] = malloc(tile_bytes)) != NULL);
+    for (int s = 0; s < panel && ok; s++) ok = ((a_tiles[s] = malloc(tile_bytes)) != NULL);
+    pthread_t reader;
+    if (ok) {
+        pthread_mutex_init(&p.lock, NULL);
+        pthread_cond_init(&p.not_full, NULL);
+        pthread_cond_init(&p.not_empty, NULL);
+        ok = (pthread_create(&reader, NULL, prefetch_tiles, &p) == 0);
+        if (ok) {
+            int current_i = -1;
+            int current_j = -1;
+            for (long long r = 0; r < nb_requests && ok; r++) {
+                t_tile_request *q = &requests[r];
+                float *tile = wait_tile(&p, r);
+                if (!q->from_b) {
+                    memcpy(a_tiles[q->k % panel], tile, tile_bytes);
+                    release_tile(&p);
+                    continue;
+                }
+                if (q->i != current_i || q->j != current_j) {
+                    // a new product tile starts: store the finished one
+                    if (current_i >= 0) ok = write_tile(c, current_i, current_j, product);
+                    memset(product, 0, tile_bytes);
+                    current_i = q->i;
+                    current_j = q->j;
+                }
+                multiply_add_tile(product, a_tiles[q->k % panel], tile, a->tile_size);
+                release_tile(&p);
+            }
+            if (ok && current_i >= 0) ok = write_tile(c, current_i, current_j, product);
+            if (!ok) {
+                // let the reader finish its remaining requests
+                pthread_mutex_lock(&p.lock);
+                p.consumed = nb_requests;
+                pthread_cond_broadcast(&p.not_full);
+                pthread_mutex_unlock(&p.lock);
+            }
+            pthread_join(reader, NULL);
+            if (p.error) ok = 0;
+        }
+        pthread_mutex_destroy(&p.lock);
+        pthread_cond_destroy(&p.not_full);
+        pthread_cond_destroy(&p.not_empty);
+    }
+    if (p.file_a != NULL) fclose(p.file_a);
+    if (p.file_b != NULL) fclose(p.file_b);
+    if (p.slots != NULL) {
+        for (int s = 0; s < nb_slots; s++) free(p.slots[s]);
+    }
+    if (a_tiles != NULL) {
+        for (int s = 0; s < panel; s++) free(a_tiles[s]);
+    }
+    free(p.slots);
+    free(a_tiles);
+    free(product);
+    free(requests);
+    if (!ok) {
+        fprintf(stderr, "Error: Tiled multiplication failed\n");
+        close_tiled_matrix(c);
+        return NULL;
+    }
+    fflush(c->file);
+    return c;
+}
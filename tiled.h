@@ -0,0 +1,38 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef TILED_H
+#define TILED_H
+#include "functions.h"
+
+// Matrix stored on disk as square tiles, for matrices that do not fit in memory
+// Tile (I, J) holds rows I*tile_size.. and columns J*tile_size.., row-major, padded with zeros
+typedef struct {
+    FILE *file;         // File holding the tiles, tile (I, J) at index I * nb_tiles + J
+    char *path;         // Path of the file
+    int size;           // Matrix size (n x n)
+    int tile_size;      // Tile size (b x b)
+    int nb_tiles;       // Number of tiles per row and per column
+    unsigned char *nonzero;     // 1 for each tile that may hold a nonzero value
+} t_tiled_matrix;
+
+t_tiled_matrix* create_tiled_matrix(const char *, int, int);
+
+t_tiled_matrix* open_tiled_matrix(const char *, int, int);
+
+void close_tiled_matrix(t_tiled_matrix *);
+
+int read_tile(t_tiled_matrix *, int, int, float *);
+
+int write_tile(t_tiled_matrix *, int, int, const float *);
+
+t_tiled_matrix* tiled_from_graph(a_list *, const char *, int);
+
+t_tiled_matrix* tiled_from_matrix(matrix *, const char *, int);
+
+matrix* tiled_to_matrix(t_tiled_matrix *);
+
+t_tiled_matrix* multiply_tiled(t_tiled_matrix *, t_tiled_matrix *, const char *, size_t);
+
+#endif //TILED_H
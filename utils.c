@@ -4,11 +4,11 @@
 
 #include "utils.h"
 
-static char *getID(int i)
+char *getID(int i, char *buffer)
 {
     // translate from 1,2,3, .. ,500+ to A,B,C,..,Z,AA,AB,...
-    static char buffer[10];
-    char temp[10];
+    // the result goes to the caller's buffer, so concurrent calls do not share any state
+    char temp[ID_BUFFER_SIZE];
     int index = 0;
 
     i--; // Adjust to 0-based index
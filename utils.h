@@ -1,7 +1,11 @@
 #ifndef __UTILS_H__
 #define __UTILS_H__
 
-static char *getID(int i);
+// Size of the buffers given to getID (enough for any positive int)
+#define ID_BUFFER_SIZE 10
+
+// Writes the ID of vertex i (1 -> A, 27 -> AA, ...) into buffer and returns it
+char *getID(int i, char *buffer);
 
 
 #endif
\ No newline at end of file
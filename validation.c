@@ -0,0 +1,187 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#include "validation.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Validation of a loaded graph: every row is checked in the same pass (sum, dangling vertex,
+// negative probability, self-loop only, bad target) and every defect is reported, not only the first.
+// Rows are checked in parallel; sums are accumulated in double so that rows with millions of
+// small probabilities do not drift the way a float accumulator does.
+// Each thread keeps its own list of defects over a contiguous range of vertices, so joining the
+// lists in thread order gives a report sorted by vertex.
+
+
+// Growing list of defects owned by one thread
+typedef struct {
+    t_defect *defects;
+    int size;
+    int capacity;
+    int failed;
+} t_defect_list;
+
+static void add_defect(t_defect_list *list, int vertex, t_defect_kind kind, double value) {
+    if (list->size >= list->capacity) {
+        int capacity = (list->capacity > 0) ? 2 * list->capacity : 16;
+        t_defect *grown = realloc(list->defects, capacity * sizeof(t_defect));
+        if (grown == NULL) {
+            list->failed = 1;
+            return;
+        }
+        list->defects = grown;
+        list->capacity = capacity;
+    }
+    t_defect defect = {vertex, kind, value};
+    list->defects[list->size++] = defect;
+}
+
+// Check one row and add its defects, returns |sum - 1| (0 for a dangling vertex)
+static double check_row(const a_list *graph, int v, double tolerance, t_defect_list *found) {
+    const list *row = &graph->array[v];
+    if (row->head == NULL) {
+        add_defect(found, v + 1, DEFECT_DANGLING, 0);
+        return 0;
+    }
+    double sum = 0;
+    float smallest = 0;
+    int nb_edges = 0;
+    int nb_self = 0;
+    if (row->capacity > 0) {
+        // block storage: the cells are contiguous, the sum can be vectorised
+        const cell *cells = row->head;
+        int size = row->size;
+#ifdef _OPENMP
+#pragma omp simd reduction(+:sum) reduction(min:smallest)
+#endif
+        for (int k = 0; k < size; k++) {
+            sum += cells[k].proba;
+            smallest = (cells[k].proba < smallest) ? cells[k].proba : smallest;
+        }
+        for (int k = 0; k < size; k++) {
+            if (cells[k].arr < 1 || cells[k].arr > graph->size) {
+                add_defect(found, v + 1, DEFECT_BAD_TARGET, cells[k].arr);
+            }
+            nb_self += (cells[k].arr == v + 1);
+        }
+        nb_edges = size;
+    } else {
+        for (const cell *c = row->head; c != NULL; c = c->next) {
+            sum += c->proba;
+            if (c->proba < smallest) smallest = c->proba;
+            if (c->arr < 1 || c->arr > graph->size) add_defect(found, v + 1, DEFECT_BAD_TARGET, c->arr);
+            nb_self += (c->arr == v + 1);
+            nb_edges++;
+        }
+    }
+    if (smallest < 0) add_defect(found, v + 1, DEFECT_NEGATIVE, smallest);
+    if (nb_self == nb_edges) add_defect(found, v + 1, DEFECT_SELF_LOOP_ONLY, sum);
+    double error = (sum > 1) ? sum - 1 : 1 - sum;
+    if (error > tolerance) add_defect(found, v + 1, DEFECT_BAD_SUM, sum);
+    return error;
+}
+
+// Function that checks every vertex of a loaded graph and reports all its defects
+// A row is correct when its probabilities sum to 1 within the tolerance (0.01 in check_graph)
+t_validation_report* validate_graph(const a_list *graph, double tolerance) {
+    if (graph == NULL || graph->array == NULL) {
+        fprintf(stderr, "Error: Invalid graph input (sorry ;()\n");
+        return NULL;
+    }
+    int n = graph->size;
+    int nb_threads = 1;
+#ifdef _OPENMP
+    nb_threads = omp_get_max_threads();
+#endif
+    t_defect_list *lists = calloc(nb_threads, sizeof(t_defect_list));
+    t_validation_report *report = calloc(1, sizeof(t_validation_report));
+    if (lists == NULL || report == NULL) {
+        fprintf(stderr, "Memory allocation error for validation report (sorry ;()\n");
+        free(lists);
+        free(report);
+        return NULL;
+    }
+    double max_error = 0;
+#ifdef _OPENMP
+#pragma omp parallel num_threads(nb_threads) reduction(max:max_error)
+#endif
+    {
+        int thread = 0;
+#ifdef _OPENMP
+        thread = omp_get_thread_num();
+#pragma omp for schedule(static)
+#endif
+        for (int v = 0; v < n; v++) {
+            double error = check_row(graph, v, tolerance, &lists[thread]);
+            if (error > max_error) max_error = error;
+        }
+    }
+    int failed = 0;
+    int total = 0;
+    for (int t = 0; t < nb_threads; t++) {
+        failed |= lists[t].failed;
+        total += lists[t].size;
+    }
+    report->defects = malloc((total > 0 ? total : 1) * sizeof(t_defect));
+    if (failed || report->defects == NULL) {
+        fprintf(stderr, "Memory allocation error for validation report (sorry ;()\n");
+        for (int t = 0; t < nb_threads; t++) free(lists[t].defects);
+        free(lists);
+        free_validation_report(report);
+        return NULL;
+    }
+    for (int t = 0; t < nb_threads; t++) {
+        for (int k = 0; k < lists[t].size; k++) {
+            report->defects[report->nb_defects++] = lists[t].defects[k];
+            report->counts[lists[t].defects[k].kind]++;
+        }
+        free(lists[t].defects);
+    }
+    free(lists);
+    report->max_error = max_error;
+    return report;
+}
+
+// Function that tells whether a graph is a valid Markov graph according to its report
+// Self-loop-only vertices are reported but accepted: they are absorbing states
+int validation_report_is_valid(const t_validation_report *report) {
+    return report->counts[DEFECT_BAD_SUM] == 0 && report->counts[DEFECT_DANGLING] == 0 &&
+           report->counts[DEFECT_NEGATIVE] == 0 && report->counts[DEFECT_BAD_TARGET] == 0;
+}
+
+// Function that displays a validation report
+void display_validation_report(const t_validation_report *report) {
+    for (int k = 0; k < report->nb_defects; k++) {
+        const t_defect *defect = &report->defects[k];
+        switch (defect->kind) {
+            case DEFECT_BAD_SUM:
+                printf("  Vertex %d probabilities sum to %f (should be ~1.0)\n", defect->vertex, defect->value);
+                break;
+            case DEFECT_DANGLING:
+                printf("  Vertex %d has no outgoing edge\n", defect->vertex);
+                break;
+            case DEFECT_NEGATIVE:
+                printf("  Vertex %d has a negative probability (%f)\n", defect->vertex, defect->value);
+                break;
+            case DEFECT_SELF_LOOP_ONLY:
+                printf("  Vertex %d only loops on itself (absorbing)\n", defect->vertex);
+                break;
+            default:
+                printf("  Vertex %d has an edge to the unknown vertex %d\n", defect->vertex, (int)defect->value);
+                break;
+        }
+    }
+    printf("%d bad sum(s), %d dangling, %d negative, %d self-loop only, %d bad target(s), largest error %.2e: %s\n",
+           report->counts[DEFECT_BAD_SUM], report->counts[DEFECT_DANGLING], report->counts[DEFECT_NEGATIVE],
+           report->counts[DEFECT_SELF_LOOP_ONLY], report->counts[DEFECT_BAD_TARGET], report->max_error,
+           validation_report_is_valid(report) ? "valid Markov graph" : "NOT a valid Markov graph");
+}
+
+// Function that frees a validation report
+void free_validation_report(t_validation_report *report) {
+    if (report == NULL) return;
+    free(report->defects);
+    free(report);
+}
@@ -0,0 +1,42 @@
+//
+// Created by USER on 19/10/2026.
+//
+
+#ifndef VALIDATION_H
+#define VALIDATION_H
+#include "functions.h"
+
+// Kinds of defects found by validate_graph
+typedef enum {
+    DEFECT_BAD_SUM,         // Outgoing probabilities do not sum to 1 (within the tolerance)
+    DEFECT_DANGLING,        // No outgoing edge at all
+    DEFECT_NEGATIVE,        // At least one negative probability
+    DEFECT_SELF_LOOP_ONLY,  // The only edge goes back to the vertex itself
+    DEFECT_BAD_TARGET,      // An edge goes to a vertex that does not exist
+    NB_DEFECT_KINDS
+} t_defect_kind;
+
+// One defect of one vertex
+typedef struct {
+    int vertex;             // Vertex (1-based)
+    t_defect_kind kind;     // What is wrong
+    double value;           // Row sum, smallest probability or bad target, depending on the kind
+} t_defect;
+
+// Every defect of a graph, sorted by vertex
+typedef struct {
+    t_defect *defects;              // Defects found
+    int nb_defects;                 // Number of defects
+    int counts[NB_DEFECT_KINDS];    // Number of defects of each kind
+    double max_error;               // Largest |row sum - 1| over the vertices with edges
+} t_validation_report;
+
+t_validation_report* validate_graph(const a_list *, double);
+
+int validation_report_is_valid(const t_validation_report *);
+
+void display_validation_report(const t_validation_report *);
+
+void free_validation_report(t_validation_report *);
+
+#endif //VALIDATION_H